@@ -0,0 +1,89 @@
+#ifndef ACHIEVEMENT_ENGINE_HPP
+#define ACHIEVEMENT_ENGINE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Счётчики, на которые могут опираться условия достижений
+enum class StatCounter {
+    GAMES_PLAYED,
+    GAMES_WON,
+    TOTAL_MOVES,
+    FASTEST_WIN,      // Секунды
+    BEST_SCORE,
+    LAST_WIN_MOVES,   // Итоги последней выигранной партии;
+    LAST_WIN_SECONDS, // до первой победы за сеанс не известны
+    LAST_WIN_SCORE,
+    COUNT
+};
+
+// Одно сравнение из условия: counter op value
+struct AchievementCondition {
+    enum class Op { LESS, LESS_EQUAL, GREATER, GREATER_EQUAL, EQUAL };
+
+    StatCounter counter = StatCounter::GAMES_WON;
+    Op op = Op::GREATER_EQUAL;
+    std::int64_t value = 0;
+};
+
+// Структура для хранения достижения
+struct Achievement {
+    std::string id;
+    std::string name;
+    std::string description;
+    bool unlocked = false;
+    std::string iconPath;
+
+    // Все сравнения должны выполняться
+    std::vector<AchievementCondition> conditions;
+};
+
+// Достижения из JSON-файла. Условия разбираются при загрузке в сравнения
+// счётчиков, а каждое достижение записано в индекс под счётчиками, от которых
+// зависит. Изменение счётчика помечает его, и evaluate() проверяет только
+// ещё закрытые достижения под помеченными счётчиками.
+//
+// Файл: {"achievements": [{"id", "name", "description", "icon",
+//   "when": [{"counter": "gamesWon", "op": ">=", "value": 5}, ...]}, ...]}
+// Счётчики - имена из counterName(), операции - < <= > >= ==.
+class AchievementEngine {
+public:
+    static const char* const DEFAULT_PATH;
+
+    AchievementEngine();
+
+    // false, если файл не прочитан; достижения с ошибкой в условии пропускаются
+    bool load(const std::string& path);
+
+    // Начальные значения и открытые достижения - без проверки и уведомлений
+    void initialize(const std::vector<std::string>& unlockedIds);
+    // Запоминает значение; счётчик помечается, только если оно изменилось
+    void set(StatCounter counter, std::int64_t value);
+
+    // Открывает выполненные достижения под помеченными счётчиками.
+    // Возвращает индексы открытых сейчас достижений
+    std::vector<std::size_t> evaluate();
+
+    const std::vector<Achievement>& getAchievements() const { return m_achievements; }
+    std::vector<std::string> getIds() const;
+
+    static const char* counterName(StatCounter counter);
+
+private:
+    static const int COUNTER_COUNT = static_cast<int>(StatCounter::COUNT);
+
+    bool holds(const Achievement& achievement) const;
+    void unindex(std::size_t index);
+
+    std::vector<Achievement> m_achievements;
+    std::vector<std::size_t> m_byCounter[COUNTER_COUNT]; // Закрытые достижения по счётчикам
+    std::int64_t m_values[COUNTER_COUNT];
+    std::uint32_t m_known; // Биты счётчиков, у которых уже есть значение
+    std::uint32_t m_dirty; // Биты изменившихся с прошлой проверки
+    std::vector<std::uint32_t> m_checkedAt; // Номер проверки, чтобы не проверять дважды
+    std::uint32_t m_epoch;
+};
+
+#endif // ACHIEVEMENT_ENGINE_HPP
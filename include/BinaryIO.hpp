@@ -0,0 +1,57 @@
+#ifndef BINARY_IO_HPP
+#define BINARY_IO_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Общее для двоичных файлов игры и утилит (сохранение, журналы, история,
+// рекорды, база раздач, записи партий): числа little-endian, CRC-32 и
+// запись на диск, которую сбой не оставляет наполовину.
+
+inline std::uint16_t readU16(const unsigned char* in) {
+    return static_cast<std::uint16_t>(in[0] | (in[1] << 8));
+}
+
+inline std::uint32_t readU32(const unsigned char* in) {
+    return static_cast<std::uint32_t>(in[0]) | (static_cast<std::uint32_t>(in[1]) << 8) |
+           (static_cast<std::uint32_t>(in[2]) << 16) | (static_cast<std::uint32_t>(in[3]) << 24);
+}
+
+inline std::uint64_t readU64(const unsigned char* in) {
+    return static_cast<std::uint64_t>(readU32(in)) | (static_cast<std::uint64_t>(readU32(in + 4)) << 32);
+}
+
+inline void writeU16(unsigned char* out, std::uint16_t value) {
+    out[0] = static_cast<unsigned char>(value);
+    out[1] = static_cast<unsigned char>(value >> 8);
+}
+
+inline void writeU32(unsigned char* out, std::uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+        out[i] = static_cast<unsigned char>(value >> (8 * i));
+    }
+}
+
+inline void writeU64(unsigned char* out, std::uint64_t value) {
+    for (int i = 0; i < 8; ++i) {
+        out[i] = static_cast<unsigned char>(value >> (8 * i));
+    }
+}
+
+std::uint32_t crc32(const unsigned char* bytes, std::size_t size);
+
+// fflush и сброс файла на диск (fsync / _commit)
+bool syncFile(std::FILE* file);
+
+// Запись через временный файл рядом с fsync и заменой старого целиком:
+// сбой посреди записи оставляет прежний файл
+bool writeFileAtomic(const std::string& path, const void* bytes, std::size_t size);
+
+inline bool writeFileAtomic(const std::string& path, const std::vector<unsigned char>& bytes) {
+    return writeFileAtomic(path, bytes.data(), bytes.size());
+}
+
+#endif // BINARY_IO_HPP
@@ -0,0 +1,116 @@
+#ifndef BOARD_HPP
+#define BOARD_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+// Компактное представление позиции Косынки без SFML.
+// Используется правилами, подсказками, сохранениями и офлайн-поиском:
+// позиция занимает ~180 байт, копируется memcpy и не держит указателей.
+
+// Карта кодируется 6-битным идентификатором: масть * 13 + (ранг - 1).
+// Масть и ранг совпадают по номерам с enum Suit / Rank из Card.hpp.
+using CardId = std::uint8_t;
+
+const CardId NO_CARD = 63;
+const int CARD_COUNT = 52;
+
+inline CardId makeCardId(int suit, int rank) {
+    return static_cast<CardId>(suit * 13 + (rank - 1));
+}
+
+inline int cardSuit(CardId card) {
+    return card / 13;
+}
+
+inline int cardRank(CardId card) {
+    return card % 13 + 1;
+}
+
+// Совпадает с Card::isRed(): красные масти имеют номера 1 и 2
+inline bool cardIsRed(CardId card) {
+    int suit = cardSuit(card);
+    return suit == 1 || suit == 2;
+}
+
+// Индексы стопок совпадают с порядком Game::m_piles
+const int STOCK_PILE = 0;
+const int WASTE_PILE = 1;
+const int FOUNDATION_FIRST = 2;
+const int TABLEAU_FIRST = 6;
+const int PILE_COUNT = 13;
+
+inline bool isFoundationPile(int pile) {
+    return pile >= FOUNDATION_FIRST && pile < TABLEAU_FIRST;
+}
+
+inline bool isTableauPile(int pile) {
+    return pile >= TABLEAU_FIRST && pile < PILE_COUNT;
+}
+
+struct Board {
+    static const int TABLEAU_COUNT = 7;
+    static const int FOUNDATION_COUNT = 4;
+    static const int TABLEAU_CAPACITY = 19; // 6 закрытых + 13 открытых
+    static const int TALON_CAPACITY = 24;
+
+    // Игровые стопки: карты снизу вверх, первые faceDown карт закрыты
+    CardId tableau[TABLEAU_COUNT][TABLEAU_CAPACITY];
+    std::uint8_t tableauSize[TABLEAU_COUNT];
+    std::uint8_t faceDown[TABLEAU_COUNT];
+
+    // Колода и сброс хранятся одним массивом в порядке выдачи карт:
+    // talon[0..wasteSize) - сброс (верхняя карта в talon[wasteSize - 1]),
+    // talon[wasteSize..talonSize) - колода (следующая карта в talon[wasteSize])
+    CardId talon[TALON_CAPACITY];
+    std::uint8_t talonSize;
+    std::uint8_t wasteSize;
+
+    // Верхняя карта каждой базы (NO_CARD для пустой). База одномастная,
+    // поэтому верхней карты достаточно, чтобы восстановить всю стопку
+    CardId foundation[FOUNDATION_COUNT];
+
+    // Сколько карт берётся из колоды за раз (1 или 3)
+    std::uint8_t drawCount;
+
+    Board();
+
+    void clear();
+
+    // Доступ к стопкам
+    CardId tableauTop(int column) const {
+        return tableauSize[column] ? tableau[column][tableauSize[column] - 1] : NO_CARD;
+    }
+    CardId wasteTop() const {
+        return wasteSize ? talon[wasteSize - 1] : NO_CARD;
+    }
+    CardId stockTop() const {
+        return wasteSize < talonSize ? talon[wasteSize] : NO_CARD;
+    }
+    int stockSize() const {
+        return talonSize - wasteSize;
+    }
+    int foundationRank(int index) const {
+        return foundation[index] == NO_CARD ? 0 : cardRank(foundation[index]);
+    }
+
+    // Количество карт в стопке с индексом из Game::m_piles
+    int pileSize(int pile) const;
+
+    // Сколько карт уже собрано в базах
+    int foundationCardCount() const;
+    bool isWon() const;
+
+    // Проверка целостности: 52 различные карты, размеры в пределах ёмкости
+    bool isValid() const;
+
+    bool operator==(const Board& other) const;
+    bool operator!=(const Board& other) const { return !(*this == other); }
+
+    // Короткая запись карты ("QH", "10S") и всей позиции для отладки
+    static std::string cardName(CardId card);
+    std::string toString() const;
+};
+
+#endif // BOARD_HPP
@@ -42,6 +42,7 @@ public:
     bool isRed() const;
 
     void flip();
+    void setFaceUp(bool faceUp);
     sf::FloatRect getBounds() const;
     bool contains(const sf::Vector2f& point) const;
 
@@ -62,6 +63,13 @@ public:
     static bool loadTextures(const std::string& cardsPath, const std::string& backPath);
     static void unloadTextures();
 
+    // Общий атлас лиц и рубашки: все карты стола рисуются из него одним вызовом.
+    // Пустая текстура, если атлас собрать не удалось
+    static const sf::Texture& getAtlasTexture();
+    static bool hasAtlas();
+    // Добавляет карту двумя треугольниками с текущим преобразованием
+    void appendVertices(sf::VertexArray& vertices) const;
+
     // Включение/выключение отладочного режима
     static void setDebugMode(bool debug);
     static bool isDebugMode();
@@ -75,6 +83,10 @@ private:
 
     // Получение прямоугольника текстуры для конкретной карты
     sf::IntRect getCardTextureRect() const;
+    // Лицо или рубашка в атласе, по текущей стороне
+    sf::IntRect getAtlasRect() const;
+
+    static bool buildAtlas(const std::string& cardsPath, const sf::Image& back);
 
     Suit m_suit;
     Rank m_rank;
@@ -88,6 +100,9 @@ private:
     // Статические текстуры, общие для всех карт
     static sf::Texture s_cardTexture;
     static sf::Texture s_backTexture;
+    static sf::Texture s_atlasTexture;
+    static bool s_atlasReady;
+    static sf::Vector2i s_atlasBackCell; // Левый верхний угол рубашки в атласе
 
     // Отладочный режим
     static bool s_debugMode;
@@ -0,0 +1,50 @@
+#ifndef CARD_BATCH_RENDERER_HPP
+#define CARD_BATCH_RENDERER_HPP
+
+#include "Pile.hpp"
+#include <SFML/Graphics.hpp>
+#include <memory>
+#include <vector>
+
+// Рисует все карты стола одним вызовом draw: карты стопок собраны в один
+// массив вершин над общим атласом Card::getAtlasTexture(). Массив
+// пересобирается, только когда у какой-то карты сменились положение,
+// масштаб или сторона; иначе кадр отправляет готовые вершины.
+// Перетаскиваемые карты двигаются каждый кадр и идут вторым, маленьким
+// массивом поверх стола.
+//
+// Без атласа или в отладочном режиме карты рисуются по одной, как раньше.
+class CardBatchRenderer {
+public:
+    CardBatchRenderer();
+
+    // Пересобирает массив стола, если карты изменились; true - пересобран
+    bool refresh(const std::vector<std::shared_ptr<Pile>>& piles);
+
+    // Рамки стопок под картами рисует вызывающий (Pile::drawFrame)
+    void drawBoard(sf::RenderTarget& target, const std::vector<std::shared_ptr<Pile>>& piles);
+    void drawDragged(sf::RenderTarget& target, const std::vector<std::shared_ptr<Card>>& cards);
+
+    // Сколько раз пересобирался массив стола: меняется вместе с картинкой стола
+    unsigned getRebuildCount() const { return m_rebuildCount; }
+
+private:
+    // То, от чего зависят вершины карты
+    struct CardState {
+        const Card* card;
+        sf::Vector2f position;
+        sf::Vector2f scale;
+        bool faceUp;
+    };
+
+    static CardState captureState(const Card& card);
+    bool isCurrent(const std::vector<std::shared_ptr<Pile>>& piles) const;
+    void rebuild(const std::vector<std::shared_ptr<Pile>>& piles);
+
+    sf::VertexArray m_board;
+    sf::VertexArray m_dragged;
+    std::vector<CardState> m_states; // Карты стола в порядке отрисовки на момент сборки
+    unsigned m_rebuildCount;
+};
+
+#endif // CARD_BATCH_RENDERER_HPP
@@ -0,0 +1,66 @@
+#ifndef DEAL_HPP
+#define DEAL_HPP
+
+#include "Board.hpp"
+#include <cstdint>
+#include <utility>
+
+// Номер раздачи однозначно задаёт расклад на любой сборке и платформе.
+//
+// Генератор - SplitMix64 с состоянием, равным номеру раздачи:
+//   state += 0x9E3779B97F4A7C15
+//   z = state; z = (z ^ z >> 30) * 0xBF58476D1CE4E5B9
+//   z = (z ^ z >> 27) * 0x94D049BB133111EB; результат z ^ z >> 31
+// Число из [0, n) - старшие 32 бита результата по модулю n; значения
+// из неполного последнего отрезка отбрасываются, поэтому выбор равновероятен.
+// Тасовка - Фишер-Йетс: для i от n-1 до 1 элемент i меняется с элементом
+// случайного j из [0, i]. Ни std::shuffle, ни распределения стандартной
+// библиотеки не используются: их реализация зависит от компилятора.
+class DealRandom {
+public:
+    explicit DealRandom(std::uint64_t seed) : m_state(seed) {}
+
+    std::uint64_t next() {
+        std::uint64_t z = (m_state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    // Равновероятное число из [0, bound), bound > 0
+    std::uint32_t below(std::uint32_t bound) {
+        const std::uint32_t limit = 0xFFFFFFFFu - 0xFFFFFFFFu % bound;
+        std::uint32_t value;
+        do {
+            value = static_cast<std::uint32_t>(next() >> 32);
+        } while (value >= limit);
+        return value % bound;
+    }
+
+private:
+    std::uint64_t m_state;
+};
+
+template <typename T>
+void shuffleDeal(T* items, int count, std::uint32_t dealNumber) {
+    DealRandom random(dealNumber);
+    for (int i = count - 1; i > 0; --i) {
+        int j = static_cast<int>(random.below(static_cast<std::uint32_t>(i + 1)));
+        std::swap(items[i], items[j]);
+    }
+}
+
+// Порядок выдачи карт: order[0] сдаётся первой. Исходная колода упорядочена
+// по мастям и рангам (как CardId: 0 - туз первой масти, 51 - король
+// четвёртой) и тасуется shuffleDeal
+void dealOrder(std::uint32_t dealNumber, CardId order[CARD_COUNT]);
+
+// Расклад раздачи: в игровую стопку i по очереди идут i+1 карт, верхняя
+// открыта; остальные карты - колода, первой берётся следующая по порядку.
+// Так же раздаёт Game::dealCards()
+Board dealBoard(std::uint32_t dealNumber, int drawCount = 1);
+
+// Случайный номер для новой игры
+std::uint32_t randomDealNumber();
+
+#endif // DEAL_HPP
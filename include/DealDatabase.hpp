@@ -0,0 +1,83 @@
+#ifndef DEAL_DATABASE_HPP
+#define DEAL_DATABASE_HPP
+
+#include "Solver.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Что известно о раздаче
+struct DealInfo {
+    SolveResult verdict = SolveResult::UNKNOWN;
+    std::uint16_t length = 0;     // Ходов в найденном решении (не больше MAX_LENGTH)
+    std::uint8_t difficulty = 0;  // 0 - решается сразу, 7 - решатель долго искал
+};
+
+// Формат файла (little-endian), открывается через mmap без разбора:
+//   заголовок 32 байта: "KDDB", uint32 версия, uint32 карт за взятие,
+//   uint32 первый номер раздачи, uint32 число раздач,
+//   uint32 число выигрышных, 8 байт резерв;
+//   затем по uint16 на раздачу подряд начиная с первого номера:
+//   биты 0-1 - вердикт (как SolveResult), 2-4 - сложность, 5-15 - длина решения.
+class DealDatabase {
+public:
+    static const char* const DEFAULT_PATH;
+    static const int MAX_LENGTH = 2047;
+
+    // База по умолчанию; открывается при первом обращении
+    static DealDatabase& getInstance();
+
+    DealDatabase();
+    ~DealDatabase();
+    DealDatabase(const DealDatabase&) = delete;
+    DealDatabase& operator=(const DealDatabase&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return m_records != nullptr; }
+
+    // false, если раздачи нет в базе
+    bool lookup(std::uint32_t dealNumber, DealInfo& info) const;
+
+    // Случайная выигрышная раздача; entropy - любое случайное число.
+    // false, если база не открыта или выигрышных нет
+    bool pickWinnable(std::uint64_t entropy, std::uint32_t& dealNumber) const;
+
+    int getDrawCount() const { return m_drawCount; }
+    std::uint32_t getFirstDeal() const { return m_firstDeal; }
+    std::uint32_t getDealCount() const { return m_dealCount; }
+    std::uint32_t getWinnableCount() const { return m_winnableCount; }
+
+private:
+    void* m_mapping;
+    std::size_t m_mappingSize;
+    const unsigned char* m_records;
+    int m_drawCount;
+    std::uint32_t m_firstDeal;
+    std::uint32_t m_dealCount;
+    std::uint32_t m_winnableCount;
+};
+
+// Собирает базу из результатов решателя, раздачи добавляются подряд
+class DealDatabaseBuilder {
+public:
+    DealDatabaseBuilder(std::uint32_t firstDeal, int drawCount);
+
+    void add(SolveResult verdict, std::size_t length, std::uint64_t nodes);
+    bool write(const std::string& path) const;
+
+    std::uint32_t getDealCount() const { return static_cast<std::uint32_t>(m_records.size()); }
+    std::uint32_t getWinnableCount() const { return m_winnableCount; }
+
+    // Сложность по числу узлов перебора: каждая ступень - вчетверо больше узлов
+    static std::uint8_t difficultyFor(std::uint64_t nodes);
+
+private:
+    std::uint32_t m_firstDeal;
+    int m_drawCount;
+    std::uint32_t m_winnableCount;
+    std::vector<std::uint16_t> m_records;
+};
+
+#endif // DEAL_DATABASE_HPP
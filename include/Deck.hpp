@@ -2,6 +2,7 @@
 #define DECK_HPP
 
 #include "Card.hpp"
+#include <cstdint>
 #include <vector>
 #include <memory>
 
@@ -10,6 +11,7 @@ public:
     Deck();
 
     void shuffle();
+    void shuffle(std::uint32_t dealNumber);
     std::shared_ptr<Card> drawCard();
     void addCard(std::shared_ptr<Card> card);
     bool isEmpty() const;
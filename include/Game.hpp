@@ -1,11 +1,16 @@
 #ifndef GAME_HPP
 #define GAME_HPP
 
+#include "Board.hpp"
+#include "CardBatchRenderer.hpp"
+#include "GameJournal.hpp"
+#include "HintCache.hpp"
 #include "Pile.hpp"
 #include "PopupImage.hpp" // Добавлено включение заголовочного файла
+#include "Replay.hpp"
+#include "UndoHistory.hpp"
 #include <vector>
 #include <memory>
-#include <stack>
 #include <SFML/Graphics.hpp>
 
 // Предварительные объявления классов
@@ -13,57 +18,23 @@ class GameTimer;
 class ScoreSystem;
 class Game;
 
-// Интерфейс команды (паттерн Команда)
-class Command {
-public:
-    virtual ~Command() = default;
-    virtual void execute() = 0;
-    virtual void undo() = 0;
-};
-
-// Команда для перемещения одной карты
-class MoveCardCommand : public Command {
-public:
-    MoveCardCommand(Game* game, std::shared_ptr<Card> card,
-                   std::shared_ptr<Pile> sourcePile, std::shared_ptr<Pile> targetPile);
-
-    void execute() override;
-    void undo() override;
-
-private:
-    Game* m_game;
-    std::shared_ptr<Card> m_card;
-    std::shared_ptr<Pile> m_sourcePile;
-    std::shared_ptr<Pile> m_targetPile;
-    bool m_flippedCardInSourcePile;
-};
-
-// Команда для перемещения нескольких карт
-class MoveCardsCommand : public Command {
-public:
-    MoveCardsCommand(Game* game, const std::vector<std::shared_ptr<Card>>& cards,
-                    std::shared_ptr<Pile> sourcePile, std::shared_ptr<Pile> targetPile,
-                    bool flippedCardInSourcePile = false);
-
-    void execute() override;
-    void undo() override;
-
-private:
-    Game* m_game;
-    std::vector<std::shared_ptr<Card>> m_cards;
-    std::shared_ptr<Pile> m_sourcePile;
-    std::shared_ptr<Pile> m_targetPile;
-    bool m_flippedCardInSourcePile;
-};
-
 class Game {
 public:
     Game();
     ~Game();
 
+    // Новая раздача; если есть база раздач, то только выигрышная
     void initialize();
+    // Раздача с заданным номером (см. Deal.hpp)
+    void initialize(std::uint32_t dealNumber);
     void update(sf::Time deltaTime);
     void draw(sf::RenderWindow& window);
+    // draw() по частям: неподвижный стол (рамки и карты в стопках) и то,
+    // что меняется от кадра к кадру (подсказка, перетаскивание, всплывающее окно)
+    void drawTable(sf::RenderTarget& target);
+    void drawOverlay(sf::RenderTarget& target);
+    // Номер текущей картинки стола: меняется, когда меняется drawTable()
+    unsigned refreshTable();
 
     void handleMousePressed(const sf::Vector2f& position);
     void handleMouseMoved(const sf::Vector2f& position);
@@ -71,7 +42,27 @@ public:
 
     bool isGameOver() const;
     void reset();
+    void reset(std::uint32_t dealNumber);
+    std::uint32_t getDealNumber() const { return m_dealNumber; }
     void undo();
+    void redo();
+    bool canUndo() const { return m_history.canUndo(); }
+    bool canRedo() const { return m_history.canRedo(); }
+    const UndoHistory& getHistory() const { return m_history; }
+    // История загруженной партии (от старого хода к последнему)
+    void restoreHistory(const std::vector<Move>& moves);
+
+    // Позиция, таймер, счёт и история для сохранения
+    SaveData makeSaveData() const;
+    // Продолжение сохранённой партии
+    bool restoreSaveData(const SaveData& data);
+    // Включает журнал партии (GameJournal) с номерами записей после sequence
+    void startJournal(std::uint32_t sequence);
+
+    // Единая точка для ходов игрока: перекладывает карты, открывает карту
+    // в исходной игровой стопке (выставляет Move::FLIPPED) и записывает ход
+    // в историю. Индексы стопок - как в Board. false, если ход невозможен
+    bool executeMove(Move& move);
 
     // Методы для команд
     void moveCard(std::shared_ptr<Card> card, std::shared_ptr<Pile> sourcePile, std::shared_ptr<Pile> targetPile);
@@ -124,6 +115,21 @@ public:
         return nullptr;
     }
 
+    // Индекс стопки в порядке Board (STOCK_PILE, WASTE_PILE, ...), -1 если не найдена
+    int getPileIndex(const Pile* pile) const;
+
+    // Снимок текущей позиции в компактном виде (перетаскиваемые карты
+    // считаются лежащими в исходной стопке)
+    Board captureBoard() const;
+
+    // Допустимые ходы текущей позиции; при вызове пересчитываются только
+    // стопки, изменившиеся с прошлого вызова (см. Pile::getVersion())
+    const HintCache& getHintCache() const;
+
+    // Раскладывает существующие карты по стопкам согласно позиции.
+    // Новые карты не создаются; история отмены очищается.
+    bool applyBoard(const Board& board);
+
     // Методы для взаимодействия с таймером и системой очков
     void setTimer(std::shared_ptr<GameTimer> timer) {
         m_timer = timer;
@@ -151,9 +157,15 @@ public:
     void clearHint();
     bool isShowingHint() const { return m_showingHint; }
 
+    // Пульсирующая подсказка или всплывающее изображение: кадр нужен каждый раз
+    bool isAnimating() const { return m_showingHint || m_popupImage.isVisible(); }
+
     bool hasPendingVictory() const { return m_pendingVictory; }
     void resetPendingVictory() { m_pendingVictory = false; }
 
+    // Итог партии в историю партий (GameHistory), один раз за партию
+    void recordResult(bool won);
+
 private:
     // Поля для системы подсказок
     std::shared_ptr<Card> m_hintSourceCard = nullptr;
@@ -168,13 +180,30 @@ private:
     bool shouldAutoMoveAceToFoundation(std::shared_ptr<Card> card);
     std::shared_ptr<Pile> findFoundationForAce();
     bool tryAutoMoveAceToFoundation(std::shared_ptr<Card> card, std::shared_ptr<Pile> sourcePile);
+    // Куда переложить карту с индексом cardIndex (и карты над ней) по двойному клику:
+    // сначала база, затем игровая стопка; nullptr, если хода нет
+    std::shared_ptr<Pile> findAutoMoveTarget(const Pile* sourcePile, size_t cardIndex) const;
     void createPiles();
+    // Переписывает стопку index в позиции по текущим картам
+    void readPile(Board& board, int index) const;
+    void readCards(Board& board, int index, const Pile& pile) const;
     void createCards();
+    // Собирает колоду из пула в порядке раздачи m_dealNumber
+    void shuffleCards();
     void dealCards();
     bool checkVictory() const;
 
-    // Метод для перемещения карты с управляемым переворотом следующей карты
-    void moveCardWithFlip(std::shared_ptr<Card> card, std::shared_ptr<Pile> sourcePile, std::shared_ptr<Pile> targetPile);
+    // Ход между стопками Game по указателям
+    Move pileMove(const Pile* from, const Pile* to, size_t count) const;
+    // Выполнение и откат хода без записи в историю
+    void performMove(Move& move);
+    void revertMove(const Move& move);
+    // Новая запись партии с текущей позиции
+    void startReplay();
+    // Раздача номер dealNumber без событий новой игры (статистика, журнал, запись)
+    void setupDeal(std::uint32_t dealNumber);
+    // Итог текущей партии в историю и сброс таймера, счёта, истории ходов
+    void finishCurrentGame();
 
     std::vector<std::shared_ptr<Pile>> m_piles;
     std::shared_ptr<Pile> m_stockPile;
@@ -182,12 +211,22 @@ private:
     std::vector<std::shared_ptr<Pile>> m_foundationPiles;
     std::vector<std::shared_ptr<Pile>> m_tableauPiles;
 
+    // Все карты игры, индекс - CardId; создаются один раз вместе со стопками
+    std::vector<std::shared_ptr<Card>> m_cardPool;
+
     std::shared_ptr<Pile> m_dragSourcePile;
     std::vector<std::shared_ptr<Card>> m_draggedCards;
     sf::Vector2f m_dragOffset;
 
-    // Паттерн Команда для отмены действий
-    std::stack<std::unique_ptr<Command>> m_undoStack;
+    // Карты стола и перетаскиваемые - по вызову draw на каждую группу
+    CardBatchRenderer m_cardRenderer;
+
+    // История ходов для отмены и повтора
+    UndoHistory m_history;
+    // Запись текущей партии (ReplayRecorder::DEFAULT_PATH)
+    ReplayRecorder m_replay;
+    // Журнал на случай сбоя; записи отдаются фоновому потоку в update()
+    GameJournal m_journal;
 
     // Паттерн Наблюдатель
     std::vector<Observer> m_observers;
@@ -204,6 +243,21 @@ private:
     std::shared_ptr<Card> m_lastClickedCard;
 
     bool m_pendingVictory = false;
+
+    // Кэш ходов и версии стопок, по которым он посчитан
+    mutable HintCache m_hintCache;
+    mutable unsigned m_pileVersions[PILE_COUNT] = {};
+    mutable bool m_hintCacheValid = false;
+    mutable const Pile* m_cachedDragSource = nullptr;
+    mutable size_t m_cachedDragCount = 0;
+
+    // Номер текущей раздачи
+    std::uint32_t m_dealNumber = 0;
+
+    // Для истории партий
+    int m_undoCount = 0;
+    int m_hintCount = 0;
+    bool m_resultRecorded = false;
 };
 
 #endif // GAME_HPP
@@ -0,0 +1,97 @@
+#ifndef GAME_HISTORY_HPP
+#define GAME_HISTORY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Итог одной партии
+struct HistoryRecord {
+    std::uint32_t dealNumber = 0;
+    std::uint8_t drawCount = 1;   // Вариант: взятие по 1 или по 3
+    bool won = false;
+    std::uint16_t moves = 0;
+    std::uint32_t seconds = 0;
+    std::int32_t score = 0;
+    std::uint16_t undos = 0;
+    std::uint16_t hints = 0;
+    std::int64_t timestamp = 0;   // Время окончания, секунды Unix
+};
+
+// Какие партии учитывать в запросе
+struct HistoryFilter {
+    std::size_t lastGames = 0;    // Только последние N партий (0 - все)
+    std::uint8_t drawCount = 0;   // Только этот вариант (0 - любой)
+    std::int64_t since = 0;       // Только закончившиеся не раньше (0 - все)
+};
+
+struct HistorySummary {
+    std::size_t games = 0;
+    std::size_t wins = 0;
+    std::uint64_t moves = 0;      // Сумма по выигранным партиям
+    std::uint64_t winSeconds = 0; // Сумма по выигранным партиям
+    std::uint64_t undos = 0;
+    std::uint64_t hints = 0;
+    std::int32_t bestScore = 0;
+
+    double winRate() const { return games ? static_cast<double>(wins) / games : 0.0; }
+};
+
+// История партий по одной строке на партию. Файл хранится по столбцам:
+// запросу нужны лишь несколько полей, и он проходит их подряд по
+// отображённой в память странице, не разбирая строки целиком.
+//
+// Формат файла (little-endian):
+//   заголовок 32 байта: "KHST", uint32 версия, uint32 строк в блоке,
+//   uint32 число строк, 16 байт резерв;
+//   затем блоки по BLOCK_ROWS строк. В блоке столбцы идут друг за другом:
+//   int64 время, uint32 раздача, uint32 секунды, int32 счёт,
+//   uint16 ходы, uint16 отмены, uint16 подсказки, uint8 вариант, uint8 победа.
+// Новые строки дописываются в последний блок; число строк в заголовке
+// обновляется после самой строки.
+class GameHistory {
+public:
+    static const char* const DEFAULT_PATH;
+    static const std::size_t BLOCK_ROWS = 4096;
+
+    // История по умолчанию; открывается при первом обращении
+    static GameHistory& getInstance();
+
+    GameHistory();
+    ~GameHistory();
+    GameHistory(const GameHistory&) = delete;
+    GameHistory& operator=(const GameHistory&) = delete;
+
+    // Открывает или создаёт файл
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return m_file != nullptr; }
+
+    bool append(const HistoryRecord& record);
+
+    std::size_t getRowCount() const { return m_rowCount; }
+    HistoryRecord getRecord(std::size_t row) const;
+
+    HistorySummary summarize(const HistoryFilter& filter) const;
+    // Медиана времени выигранных партий; 0, если побед нет
+    std::uint32_t medianWinSeconds(const HistoryFilter& filter) const;
+    // Итоги подряд идущих групп по groupSize партий, от старых к новым
+    std::vector<HistorySummary> trend(const HistoryFilter& filter, std::size_t groupSize) const;
+
+private:
+    // Обходит блоки с нужными строками: visit(блок, первая строка, конец)
+    template <typename Visitor>
+    void scan(const HistoryFilter& filter, Visitor visit) const;
+
+    bool map(std::size_t size);
+    void unmap();
+
+    std::FILE* m_file;
+    void* m_mapping;
+    std::size_t m_mappingSize;
+    std::size_t m_rowCount;
+};
+
+#endif // GAME_HISTORY_HPP
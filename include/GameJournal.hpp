@@ -0,0 +1,107 @@
+#ifndef GAME_JOURNAL_HPP
+#define GAME_JOURNAL_HPP
+
+#include "SaveFormat.hpp"
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Журнал текущей партии на случай сбоя: каждый шаг игрока дописывается
+// в файл журнала, а периодически фоновый поток пишет снимок позиции
+// (файл сохранения, SaveFormat) и оставляет в журнале только более новые записи.
+// Главный поток не трогает диск: он складывает записи в память, а запись
+// и fsync делает фоновый поток, один fsync на пачку ходов за SYNC_INTERVAL_MS.
+//
+// Формат журнала: заголовок 8 байт "KJNL", uint32 версия; затем записи по 20 байт
+//   uint8 вид ('M' ход, 'U' отмена хода, 'G' новая раздача),
+//   4 байта хода (from, to, count, flags) или uint32 номер раздачи для 'G',
+//   uint24 секунды, int32 счёт, uint32 номер записи, uint32 CRC-32 первых 16 байт.
+// Номера записей идут подряд; снимок хранит номер последней вошедшей в него
+// записи, поэтому после сбоя между записью снимка и обрезкой журнала
+// старые записи просто пропускаются.
+class GameJournal {
+public:
+    static const char* const DEFAULT_JOURNAL_PATH;
+    static const char* const DEFAULT_SNAPSHOT_PATH;
+    static const int SYNC_INTERVAL_MS = 200;
+    static const std::uint32_t SNAPSHOT_INTERVAL = 128; // Записей между снимками
+
+    GameJournal(const std::string& journalPath = DEFAULT_JOURNAL_PATH,
+                const std::string& snapshotPath = DEFAULT_SNAPSHOT_PATH);
+    ~GameJournal();
+    GameJournal(const GameJournal&) = delete;
+    GameJournal& operator=(const GameJournal&) = delete;
+
+    // Запускает фоновый поток; номера записей продолжаются после sequence.
+    // Файл журнала пересоздаётся при первом снимке (до него старый журнал
+    // нужен для восстановления), поэтому сразу после start() нужен snapshot().
+    // До start() записи игнорируются
+    bool start(std::uint32_t sequence);
+    // Дописывает всё накопленное и останавливает поток
+    void stop();
+    bool isRunning() const { return m_thread.joinable(); }
+
+    // Вызываются из главного потока, без обращения к диску
+    void recordMove(const Move& move);
+    void recordUndo(const Move& move);
+    void recordNewGame(std::uint32_t dealNumber);
+
+    // Отдаёт накопленные записи фоновому потоку, проставив текущие время и счёт
+    void commit(int seconds, int score);
+
+    // Номер последней записи, включая ещё не отданные commit()
+    std::uint32_t getSequence() const { return m_sequence + static_cast<std::uint32_t>(m_uncommitted.size()); }
+
+    // Пора ли передать снимок: прошло SNAPSHOT_INTERVAL записей или он запрошен
+    bool wantsSnapshot() const;
+    void requestSnapshot() { m_snapshotRequested = true; }
+    // Снимок позиции после всех записей, отданных commit(); пишется в фоне
+    void snapshot(SaveData data);
+
+    // Восстановление после сбоя: применяет к data записи журнала новее
+    // data.sequence (или начиная с первой новой раздачи, если hasBase == false).
+    // Возвращает число применённых записей; на первой битой или
+    // не сходящейся с позицией записи останавливается
+    static std::size_t recover(const std::string& journalPath, SaveData& data, bool hasBase);
+
+private:
+    struct Record {
+        char kind;
+        Move move;
+        std::uint32_t dealNumber;
+    };
+
+    void queue(char kind, const Move& move, std::uint32_t dealNumber);
+    void writerLoop();
+    bool appendRecords(const std::vector<unsigned char>& records);
+    bool writeSnapshot(const SaveData& data);
+    bool openJournal(const std::vector<unsigned char>& records);
+
+    std::string m_journalPath;
+    std::string m_snapshotPath;
+
+    // Только главный поток
+    std::vector<Record> m_uncommitted;
+    std::uint32_t m_sequence;
+    std::uint32_t m_snapshotSequence;
+    bool m_snapshotRequested;
+
+    // Общие, под m_mutex
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::vector<unsigned char> m_pending;
+    SaveData m_pendingSnapshot;
+    bool m_hasPendingSnapshot;
+    bool m_stopping;
+
+    // Только фоновый поток
+    std::thread m_thread;
+    std::FILE* m_file;
+    std::vector<unsigned char> m_written; // Записи в текущем файле журнала
+};
+
+#endif // GAME_JOURNAL_HPP
@@ -2,9 +2,11 @@
 #define GAME_STATE_HPP
 
 #include <SFML/Graphics.hpp>
+#include <cstdint>
 #include <memory>
 #include <functional>
 #include <vector>
+#include "HudLabel.hpp"
 #include "SettingsManager.hpp" // Добавлен include для SettingsManager
 #include "ResourceManager.hpp"  // Добавлен include для ResourceManager
 
@@ -18,6 +20,8 @@ public:
     virtual void handleEvent(sf::RenderWindow& window, const sf::Event& event, Game& game) = 0;
     virtual void update(sf::Time deltaTime, Game& game) = 0;
     virtual void render(sf::RenderWindow& window, Game& game) = 0;
+    // Меняется ли экран без событий; такой экран рисуется каждый кадр
+    virtual bool isAnimating(const Game& game) const { return false; }
 
 protected:
     // Общий фон для всех состояний
@@ -126,6 +130,7 @@ public:
     void handleEvent(sf::RenderWindow& window, const sf::Event& event, Game& game) override;
     void update(sf::Time deltaTime, Game& game) override;
     void render(sf::RenderWindow& window, Game& game) override;
+    bool isAnimating(const Game& game) const override;
 
 private:
     // Вспомогательные методы для создания и обновления кнопок
@@ -182,18 +187,39 @@ public:
     void handleEvent(sf::RenderWindow& window, const sf::Event& event, Game& game) override;
     void update(sf::Time deltaTime, Game& game) override;
     void render(sf::RenderWindow& window, Game& game) override;
+    bool isAnimating(const Game& game) const override;
 
 private:
-    sf::Text m_undoText;
-    sf::Text m_resetText;
-    sf::Text m_menuText;
-    sf::Text m_hintText;
-    sf::Text m_autoCompleteText;
-    sf::Text m_timerText;
-    sf::Text m_scoreText;
+    // Перерисовывает слой стола, если изменилось что-то из того, что в нём
+    // нарисовано; false - слой недоступен и стол рисуется напрямую
+    bool updateTableLayer(sf::RenderWindow& window, Game& game);
+
+    // Слой стола: фон, рамки стопок и лежащие карты. Каждый кадр выводится
+    // одним спрайтом, а поверх рисуется только меняющееся
+    sf::RenderTexture m_tableLayer;
+    sf::Sprite m_tableSprite;
+    bool m_tableLayerBuilt;
+    bool m_tableLayerFailed;
+    // От чего зависит картинка слоя
+    unsigned m_tableVersion;
+    const sf::Texture* m_tableBackground;
+    sf::Vector2u m_tableWindowSize;
+    sf::Vector2f m_tableViewSize;
+    sf::Vector2f m_tableViewCenter;
+    sf::Color m_tableColor;
+    bool m_tableDebug;
+
+    // Подписи пересобираются только при смене значения или подсветки
+    HudLabel m_undoText;
+    HudLabel m_resetText;
+    HudLabel m_menuText;
+    HudLabel m_hintText;
+    HudLabel m_autoCompleteText;
+    HudLabel m_timerText;
+    HudLabel m_scoreText;
 
     // Добавляем кнопку выбора фона
-    sf::Text m_backgroundText;
+    HudLabel m_backgroundText;
     bool m_backgroundSelected;
 
     // Селектор фона
@@ -237,6 +263,7 @@ public:
     void handleEvent(sf::RenderWindow& window, const sf::Event& event, Game& game) override;
     void update(sf::Time deltaTime, Game& game) override;
     void render(sf::RenderWindow& window, Game& game) override;
+    bool isAnimating(const Game& game) const override;
 
 private:
     sf::Text m_victoryText;
@@ -361,13 +388,17 @@ public:
     void handleEvent(sf::RenderWindow& window, const sf::Event& event, Game& game) override;
     void update(sf::Time deltaTime, Game& game) override;
     void render(sf::RenderWindow& window, Game& game) override;
+    bool isAnimating(const Game& game) const override;
 
 private:
     void createUI();
+    // Таблицы рекордов грузятся в фоне, тексты пересобираются при их изменении
+    void updateLeaders(Game& game);
 
     enum class Page {
         STATS,
-        ACHIEVEMENTS
+        ACHIEVEMENTS,
+        LEADERS
     };
 
     Page m_currentPage;
@@ -376,11 +407,17 @@ private:
     sf::Text m_titleText;
     sf::Text m_statsTabText;
     sf::Text m_achievementsTabText;
+    sf::Text m_leadersTabText;
     sf::Text m_backText;
 
     // Статистика
     std::vector<sf::Text> m_statsTexts;
 
+    // Рекорды
+    std::vector<sf::Text> m_leaderTexts;
+    std::uint32_t m_leadersVersion;
+    bool m_leadersBuilt;
+
 
     // Достижения
     std::vector<sf::Sprite> m_achievementIcons;
@@ -391,6 +428,7 @@ private:
     bool m_backSelected;
     bool m_statsTabSelected;
     bool m_achievementsTabSelected;
+    bool m_leadersTabSelected;
 
     int m_scroll;
     int m_maxScroll;
@@ -405,6 +443,7 @@ public:
     void handleEvent(sf::RenderWindow& window, const sf::Event& event, Game& game);
     void update(sf::Time deltaTime, Game& game);
     void render(sf::RenderWindow& window, Game& game); // Добавленный метод
+    bool isAnimating(const Game& game) const;
 
     GameState* getCurrentState() const {
         return m_currentState.get();
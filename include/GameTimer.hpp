@@ -32,6 +32,14 @@ public:
         m_seconds = 0;
     }
 
+    // Продолжение сохранённой партии с заданного времени
+    void setElapsedSeconds(int seconds) {
+        m_seconds = seconds;
+        if (!m_paused) {
+            m_clock.restart();
+        }
+    }
+
     // Обновление таймера
     void update() {
         if (!m_paused) {
@@ -54,6 +62,12 @@ public:
         }
     }
 
+    // Сколько осталось до смены секунды; имеет смысл, пока таймер идёт
+    sf::Time getTimeToNextSecond() const {
+        sf::Int64 elapsed = m_clock.getElapsedTime().asMicroseconds();
+        return sf::microseconds(1000000 - elapsed % 1000000);
+    }
+
     // Получение отформатированного времени (MM:SS)
     std::string getFormattedTime() const {
         int seconds = getElapsedSeconds();
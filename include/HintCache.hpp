@@ -0,0 +1,48 @@
+#ifndef HINT_CACHE_HPP
+#define HINT_CACHE_HPP
+
+#include "Board.hpp"
+#include "MoveGenerator.hpp"
+#include <cstdint>
+
+// Допустимые ходы позиции, которые пересчитываются только для изменившихся
+// стопок. Из одной стопки в другую возможен не больше чем один ход
+// (в открытой части стопки нет двух карт одного ранга), поэтому ходы
+// хранятся таблицей «откуда x куда». После изменения стопки p пересчитываются
+// пары с p с любой стороны, а если изменилась база - все пары в базы:
+// туз идёт в первую пустую. Порядок ходов совпадает с generateMoves().
+class HintCache {
+public:
+    HintCache();
+
+    // Пересчитать всё для новой позиции
+    void reset(const Board& board);
+
+    // Позиция изменилась только в стопках из dirtyMask (бит 1 << индекс стопки).
+    // Колода и сброс - один массив, поэтому изменение любой из них
+    // пересчитывает ходы обеих
+    void update(const Board& board, std::uint32_t dirtyMask);
+
+    const Board& getBoard() const { return m_board; }
+    const MoveList& getMoves() const { return m_moves; }
+
+    // Первый ход с наибольшим положительным приоритетом (hintPriority),
+    // nullptr - если есть только взятие из колоды или ходов нет
+    const Move* getBestHint() const { return m_bestHint >= 0 ? &m_moves[m_bestHint] : nullptr; }
+
+    // Сколько пар стопок пересчитано с момента создания (для профилирования)
+    std::uint64_t getRecomputedPairs() const { return m_recomputedPairs; }
+
+private:
+    void recomputePair(int from, int to);
+    void rebuildMoves();
+
+    Board m_board;
+    Move m_pairs[PILE_COUNT][PILE_COUNT]; // count == 0 - хода нет
+    Move m_stockMove;                     // Взятие или переворот сброса
+    MoveList m_moves;
+    int m_bestHint; // Индекс в m_moves, -1 - нет
+    std::uint64_t m_recomputedPairs;
+};
+
+#endif // HINT_CACHE_HPP
@@ -6,6 +6,7 @@
 #include "Card.hpp"
 #include "Pile.hpp"
 #include "AnimationManager.hpp"
+#include "MoveGenerator.hpp"
 
 // Предварительное объявление классов
 class Game;
@@ -39,8 +40,8 @@ public:
     std::vector<Pile*> findPossibleMoves(const Card* card) const;
 
 private:
-    // Добавление возможных подсказок для конкретной карты
-    void addCardHints(std::vector<Hint>& hints, std::shared_ptr<Card> card, std::shared_ptr<Pile> sourcePile);
+    // Подсказка для хода из генератора
+    Hint makeHint(const Move& move) const;
 
     Game& m_game;
     Context* m_context = nullptr; // Указатель на контекст (может быть nullptr)
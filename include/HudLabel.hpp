@@ -0,0 +1,59 @@
+#ifndef HUD_LABEL_HPP
+#define HUD_LABEL_HPP
+
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <string>
+
+// Подпись интерфейса поверх стола. Геометрию глифов хранит sf::Text, а
+// метка следит, чтобы он пересобирал её только при смене показанного:
+// строка значения строится лишь тогда, когда значение изменилось (таймер -
+// раз в секунду), цвет меняется лишь при смене подсветки.
+//
+// Счётчики пересборок - для профилирования: сколько подписей пересобрано
+// за текущий кадр и за всё время.
+class HudLabel : public sf::Drawable {
+public:
+    HudLabel();
+
+    void init(const sf::Font& font, const std::string& string, unsigned characterSize,
+              const sf::Vector2f& position);
+    void setColors(const sf::Color& normal, const sf::Color& highlighted);
+
+    // format(value) вызывается только при новом значении; true - текст пересобран
+    template <typename Format>
+    bool setValue(std::int64_t value, Format format) {
+        if (m_hasValue && value == m_value) {
+            return false;
+        }
+        m_value = value;
+        m_hasValue = true;
+        reshape(format(value));
+        return true;
+    }
+
+    void setHighlighted(bool highlighted);
+
+    sf::FloatRect getGlobalBounds() const { return m_text.getGlobalBounds(); }
+
+    // Главный цикл сбрасывает счётчик кадра в начале каждого кадра
+    static void beginFrame() { s_frameRebuilds = 0; }
+    static unsigned getFrameRebuilds() { return s_frameRebuilds; }
+    static std::uint64_t getTotalRebuilds() { return s_totalRebuilds; }
+
+private:
+    virtual void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+    void reshape(const std::string& string);
+
+    sf::Text m_text;
+    sf::Color m_normalColor;
+    sf::Color m_highlightedColor;
+    bool m_highlighted;
+    std::int64_t m_value;
+    bool m_hasValue;
+
+    static unsigned s_frameRebuilds;
+    static std::uint64_t s_totalRebuilds;
+};
+
+#endif // HUD_LABEL_HPP
@@ -0,0 +1,101 @@
+#ifndef LEADERBOARD_HPP
+#define LEADERBOARD_HPP
+
+#include "GameHistory.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+enum class LeaderboardMetric {
+    SCORE, // Больше - лучше
+    TIME,  // Секунды, меньше - лучше
+    MOVES  // Меньше - лучше
+};
+
+struct LeaderboardEntry {
+    std::int32_t value = 0;
+    std::uint32_t dealNumber = 0;
+    std::int64_t timestamp = 0;
+};
+
+// Локальные таблицы рекордов по выигранным партиям: для каждого варианта
+// (взятие по 1 или по 3) и для каждой раздачи варианта - по таблице на
+// каждую метрику. Таблица - вектор, отсортированный от лучшего результата,
+// поэтому первые N и место результата находятся двоичным поиском.
+//
+// Победы копятся в файле только на дозапись; при запуске фоновый поток
+// читает его и строит таблицы, а новые победы вставляет он же, чтобы
+// конец партии не ждал ни диска, ни сдвига больших таблиц.
+//
+// Формат файла (little-endian): заголовок 8 байт "KLDB", uint32 версия;
+// записи по 28 байт: uint8 вариант, uint8 резерв, uint16 ходы,
+// uint32 раздача, int32 счёт, uint32 секунды, int64 время,
+// uint32 CRC-32 первых 24 байт.
+class Leaderboard {
+public:
+    static const char* const DEFAULT_PATH;
+
+    // Таблицы по умолчанию; загружаются в фоне при первом обращении
+    static Leaderboard& getInstance();
+
+    Leaderboard();
+    ~Leaderboard();
+    Leaderboard(const Leaderboard&) = delete;
+    Leaderboard& operator=(const Leaderboard&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+
+    // Главный поток: ставит партию в очередь фонового потока.
+    // Проигранные партии в таблицы не попадают
+    void submit(const HistoryRecord& record);
+
+    // Меняется при каждом изменении таблиц - чтобы знать, когда перерисовать
+    std::uint32_t getVersion() const { return m_version.load(); }
+    bool isLoaded() const { return m_loaded.load(); }
+
+    // Лучшие count результатов, от лучшего
+    std::vector<LeaderboardEntry> top(LeaderboardMetric metric, std::uint8_t drawCount, std::size_t count) const;
+    std::vector<LeaderboardEntry> topForDeal(LeaderboardMetric metric, std::uint8_t drawCount,
+                                             std::uint32_t dealNumber, std::size_t count) const;
+    // Место (с 1), которое занял бы результат value
+    std::size_t rank(LeaderboardMetric metric, std::uint8_t drawCount, std::int32_t value) const;
+    std::size_t size(LeaderboardMetric metric, std::uint8_t drawCount) const;
+
+private:
+    static const int METRIC_COUNT = 3;
+
+    struct Tables {
+        std::vector<LeaderboardEntry> byMetric[METRIC_COUNT];
+    };
+
+    void workerLoop();
+    void insert(const HistoryRecord& record);
+    const Tables* findTables(std::uint8_t drawCount) const;
+    const Tables* findDealTables(std::uint8_t drawCount, std::uint32_t dealNumber) const;
+
+    std::string m_path;
+    std::thread m_thread;
+    std::atomic<std::uint32_t> m_version;
+    std::atomic<bool> m_loaded;
+
+    // Очередь побед, под m_queueMutex
+    std::mutex m_queueMutex;
+    std::condition_variable m_wake;
+    std::deque<HistoryRecord> m_queue;
+    bool m_stopping;
+
+    // Таблицы пишет только фоновый поток, под m_mutex
+    mutable std::mutex m_mutex;
+    Tables m_variants[2]; // Взятие по 1 и по 3
+    std::unordered_map<std::uint64_t, Tables> m_deals;
+};
+
+#endif // LEADERBOARD_HPP
@@ -0,0 +1,88 @@
+#ifndef MOVE_GENERATOR_HPP
+#define MOVE_GENERATOR_HPP
+
+#include "Board.hpp"
+#include <cstdint>
+
+// Ход в компактном виде (4 байта). Вид хода определяется стопками:
+//   STOCK -> WASTE       - взять count карт из колоды
+//   WASTE -> STOCK       - перевернуть сброс обратно в колоду (count = размер сброса)
+//   WASTE/TABLEAU/FOUNDATION -> FOUNDATION/TABLEAU - переложить count верхних карт
+struct Move {
+    std::uint8_t from = 0;
+    std::uint8_t to = 0;
+    std::uint8_t count = 0;
+    std::uint8_t flags = 0;
+
+    // Флаг заполняется applyMove(): после хода открылась карта в исходной стопке
+    static const std::uint8_t FLIPPED = 1;
+
+    bool isDraw() const { return from == STOCK_PILE && to == WASTE_PILE; }
+    bool isRecycle() const { return from == WASTE_PILE && to == STOCK_PILE; }
+    bool flipped() const { return (flags & FLIPPED) != 0; }
+
+    bool operator==(const Move& other) const {
+        return from == other.from && to == other.to && count == other.count;
+    }
+    bool operator!=(const Move& other) const { return !(*this == other); }
+};
+
+// Перечисляет все допустимые ходы в буфер вызывающей стороны, без выделений
+// памяти. Возвращает число записанных ходов (не больше capacity).
+// Порядок: в базы, из сброса в игровые стопки, между игровыми стопками,
+// из баз обратно, затем взятие карты из колоды или переворот сброса.
+int generateMoves(const Board& board, Move* moves, int capacity);
+
+// Можно ли положить карту на игровую стопку / в базу (правила Pile)
+bool canPlaceOnTableau(const Board& board, CardId card, int column);
+int findFoundationFor(const Board& board, CardId card);
+
+// Применение и откат хода. applyMove() выставляет Move::FLIPPED,
+// undoMove() ожидает ход в том виде, в каком его вернул applyMove()
+void applyMove(Board& board, Move& move);
+void undoMove(Board& board, const Move& move);
+
+// Для ходов из файлов (записи партий, сохранения).
+// isLegalMove: ход есть среди generateMoves() позиции.
+// undoMoveChecked: откатывает ход, только если он допустим в предыдущей
+// позиции и ведёт из неё в board с тем же флагом FLIPPED; иначе board не меняется
+bool isLegalMove(const Board& board, const Move& move);
+bool undoMoveChecked(Board& board, const Move& move);
+
+// Приоритет хода для подсказки: чем больше, тем полезнее.
+// 0 - взятие из колоды и переворот сброса (предлагаются, если нет другого),
+// -1 - ходы, которые не стоит подсказывать (короля с пустого места на пустое,
+// карту из базы обратно)
+int hintPriority(const Board& board, const Move& move);
+
+// Буфер ходов фиксированного размера для вызова на стеке
+class MoveList {
+public:
+    // С запасом больше максимального числа допустимых ходов в Косынке
+    static const int CAPACITY = 192;
+
+    MoveList() : m_size(0) {}
+
+    void generate(const Board& board) {
+        m_size = generateMoves(board, m_moves, CAPACITY);
+    }
+
+    void clear() { m_size = 0; }
+    void add(const Move& move) {
+        if (m_size < CAPACITY) {
+            m_moves[m_size++] = move;
+        }
+    }
+
+    int size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+    const Move& operator[](int index) const { return m_moves[index]; }
+    const Move* begin() const { return m_moves; }
+    const Move* end() const { return m_moves + m_size; }
+
+private:
+    Move m_moves[CAPACITY];
+    int m_size;
+};
+
+#endif // MOVE_GENERATOR_HPP
@@ -0,0 +1,98 @@
+#ifndef PARALLEL_SOLVER_HPP
+#define PARALLEL_SOLVER_HPP
+
+#include "Solver.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Статистика одного потока решателя
+struct SolverThreadStats {
+    std::uint64_t nodes = 0;
+    std::uint64_t tasks = 0;   // Выполнено подзадач (своих и украденных)
+    std::uint64_t steals = 0;  // Подзадач украдено у других потоков
+    std::uint64_t donated = 0; // Подзадач отдано простаивающим потокам
+    double seconds = 0.0;
+
+    double nodesPerSecond() const { return seconds > 0.0 ? nodes / seconds : 0.0; }
+};
+
+struct ParallelSolution : Solution {
+    std::vector<SolverThreadStats> threads;
+};
+
+// Параллельный вариант Solver: дерево поиска делится между потоками.
+// Каждый поток ведёт свою очередь подзадач и ищет в глубину; когда есть
+// простаивающие потоки, он отдаёт в очередь непройденные ветви текущего
+// узла, а простаивающие потоки крадут самые старые (крупные) ветви у других.
+// Таблица просмотренных позиций общая для всех потоков, остановка - по флагу.
+class ParallelSolver {
+public:
+    // threadCount = 0 - по числу ядер
+    explicit ParallelSolver(const SolverLimits& limits = SolverLimits(), int threadCount = 0);
+
+    ParallelSolution solve(const Board& board);
+
+    // Прерывает идущий solve() из другого потока; вердикт будет UNKNOWN
+    void cancel() { m_stop.store(true); m_cancelled.store(true); }
+
+    int getThreadCount() const { return m_threadCount; }
+    const TranspositionTable& getTable() const { return m_table; }
+
+private:
+    // Подзадача: позиция и ходы, которыми она получена из корня
+    struct Task {
+        Board board;
+        std::uint64_t hash = 0;
+        std::vector<Move> path;
+        int depth = 0;
+    };
+
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+        std::atomic<int> size{0}; // Для проверки без блокировки
+    };
+
+    struct Worker {
+        int index = 0;
+        std::vector<Move> path;
+        std::uint64_t pendingNodes = 0; // Ещё не добавлены в общий счётчик
+        SolverThreadStats stats;
+    };
+
+    static const int NODE_BATCH = 256;
+
+    void run(Worker& worker);
+    bool search(Worker& worker, const Board& position, std::uint64_t hash, int depth);
+    bool takeTask(Worker& worker, Task& task);
+    void pushTask(int queue, Task&& task);
+    void flushNodes(Worker& worker);
+    void reportWin(const std::vector<Move>& path);
+
+    SolverLimits m_limits;
+    int m_threadCount;
+
+    std::vector<std::unique_ptr<WorkQueue>> m_queues;
+    TranspositionTable m_table;
+    bool m_tableUsed;
+
+    std::atomic<bool> m_stop;
+    std::atomic<bool> m_cancelled;
+    std::atomic<bool> m_aborted;
+    std::atomic<bool> m_depthLimited;
+    std::atomic<bool> m_found;
+    std::atomic<int> m_idle;
+    std::atomic<std::int64_t> m_pending; // Подзадачи в очередях и в работе
+    std::atomic<std::uint64_t> m_nodes;
+    std::chrono::steady_clock::time_point m_startTime;
+
+    std::mutex m_solutionMutex;
+    std::vector<Move> m_solution;
+};
+
+#endif // PARALLEL_SOLVER_HPP
@@ -2,6 +2,7 @@
 #define PILE_HPP
 
 #include "Card.hpp"
+#include <algorithm>
 #include <vector>
 #include <memory>
 #include <functional>
@@ -17,11 +18,26 @@ enum class PileType {
     TABLEAU
 };
 
-// Интерфейс для стратегии размещения карт (паттерн Стратегия)
+// Интерфейс для стратегии размещения карт (паттерн Стратегия).
+// Один вызов расставляет карты стопки с индекса first до верха. Карты идут
+// веером без разрывов, от нижней к верхней, поэтому стопку целиком покрывают
+// нижняя и верхняя карты, а карту под точкой стратегия находит по своей
+// геометрии, не перебирая стопку
 class LayoutStrategy {
 public:
     virtual ~LayoutStrategy() = default;
-    virtual void layout(std::shared_ptr<Card> card, size_t index, const sf::Vector2f& basePos) = 0;
+    virtual void layout(const std::vector<std::shared_ptr<Card>>& cards, size_t first, const sf::Vector2f& basePos) = 0;
+    // Индекс верхней карты, накрывающей точку, или cards.size()
+    virtual size_t cardAt(const std::vector<std::shared_ptr<Card>>& cards, const sf::Vector2f& point) const = 0;
+
+protected:
+    static bool covers(const Card& card, const sf::Vector2f& point) {
+        return card.getBounds().contains(point);
+    }
+    // Карты лежат в одной точке: видна только верхняя
+    static size_t topCardAt(const std::vector<std::shared_ptr<Card>>& cards, const sf::Vector2f& point) {
+        return !cards.empty() && covers(*cards.back(), point) ? cards.size() - 1 : cards.size();
+    }
 };
 
 // Интерфейс для стратегии валидации добавления карт (паттерн Стратегия)
@@ -43,17 +59,34 @@ public:
     void addCard(std::shared_ptr<Card> card);
     std::shared_ptr<Card> removeTopCard();
     std::vector<std::shared_ptr<Card>> removeCards(size_t index);
+    // Убирает все карты, не освобождая память под них
+    void clear();
+    // Перекладывает карты начиная с index наверх стопки target без выделения памяти
+    void transferCards(size_t index, Pile& target);
 
     std::shared_ptr<Card> getTopCard() const;
     std::shared_ptr<Card> getCardAt(size_t index) const;
+
+    // Карты стопки снизу вверх (без копирования указателей)
+    const std::vector<std::shared_ptr<Card>>& getCards() const { return m_cards; }
     size_t getCardIndex(const sf::Vector2f& point) const;
 
+    // Счётчик изменений состава стопки: растёт при каждом добавлении и снятии карт
+    unsigned getVersion() const { return m_version; }
+
     bool canAddCard(std::shared_ptr<Card> card) const;
     bool canRemoveCards(size_t index) const;
     bool contains(const sf::Vector2f& point) const;
+    // Прямоугольник, занятый картами; для пустой стопки - её место
+    sf::FloatRect getBounds() const;
 
+    // Расставляет карты, сдвинутые изменениями стопки; если их нет, ничего не делает
     void update();
 
+    // Всё, кроме карт: рамка пустой стопки и отладочная метка.
+    // Карты стола рисует CardBatchRenderer
+    void drawFrame(sf::RenderTarget& target, sf::RenderStates states = sf::RenderStates::Default) const;
+
     // Сеттеры для стратегий (паттерн Стратегия)
     void setLayoutStrategy(std::unique_ptr<LayoutStrategy> strategy);
     void setValidationStrategy(std::unique_ptr<ValidationStrategy> strategy);
@@ -74,10 +107,16 @@ public:
 
 private:
     virtual void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+    // Карты начиная с index нужно расставить заново
+    void invalidateLayout(size_t index) { m_laidOut = std::min(m_laidOut, index); }
+    void drawEmptyFrame(sf::RenderTarget& target, sf::RenderStates states) const;
+    void drawDebugMarker(sf::RenderTarget& target, sf::RenderStates states) const;
 
     PileType m_type;
     sf::Vector2f m_position;
     std::vector<std::shared_ptr<Card>> m_cards;
+    unsigned m_version;
+    size_t m_laidOut; // Сколько нижних карт уже стоят на своих местах
 
     std::unique_ptr<LayoutStrategy> m_layoutStrategy;
     std::unique_ptr<ValidationStrategy> m_validationStrategy;
@@ -87,50 +126,100 @@ private:
 const float CARD_WIDTH_VISUAL = 79.0f;  // Визуальная ширина карты
 const float CARD_HEIGHT_VISUAL = 123.0f; // Визуальная высота карты
 
-// Конкретные реализации стратегий для размещения карт (паттерн Стратегия)
+// Конкретные реализации стратегий для размещения карт (паттерн Стратегия).
+// Позиция зависит только от индекса карты, поэтому расставлять можно с любого места
 class StockLayoutStrategy : public LayoutStrategy {
 public:
-    void layout(std::shared_ptr<Card> card, size_t index, const sf::Vector2f& basePos) override {
+    void layout(const std::vector<std::shared_ptr<Card>>& cards, size_t first, const sf::Vector2f& basePos) override {
         // Учитываем, что точка привязки карты в центре
-        card->setPosition(basePos.x + CARD_WIDTH_VISUAL/2.0f,
-                         basePos.y + CARD_HEIGHT_VISUAL/2.0f);
+        const sf::Vector2f position(basePos.x + CARD_WIDTH_VISUAL/2.0f, basePos.y + CARD_HEIGHT_VISUAL/2.0f);
+        for (size_t i = first; i < cards.size(); ++i) {
+            cards[i]->setPosition(position);
+        }
         // Карты в стоке всегда рубашкой вверх (управление этим происходит в другом месте)
     }
+
+    size_t cardAt(const std::vector<std::shared_ptr<Card>>& cards, const sf::Vector2f& point) const override {
+        return topCardAt(cards, point);
+    }
 };
 
 class WasteLayoutStrategy : public LayoutStrategy {
 public:
-    void layout(std::shared_ptr<Card> card, size_t index, const sf::Vector2f& basePos) override {
-        // Карты в сбросе немного смещены для наглядности
-        float xOffset = 0.0f;
-        if (index > 0) {
-            xOffset = 20.0f; // Небольшое смещение для видимости предыдущих карт
-        }
-        card->setPosition(basePos.x + CARD_WIDTH_VISUAL/2.0f + xOffset,
-                         basePos.y + CARD_HEIGHT_VISUAL/2.0f);
+    void layout(const std::vector<std::shared_ptr<Card>>& cards, size_t first, const sf::Vector2f& basePos) override {
+        // Карты в сбросе немного смещены для наглядности: все, кроме нижней,
+        // сдвинуты на 20 пикселей, чтобы была видна предыдущая карта
+        const sf::Vector2f position(basePos.x + CARD_WIDTH_VISUAL/2.0f, basePos.y + CARD_HEIGHT_VISUAL/2.0f);
+        const float xOffset = 20.0f;
+        for (size_t i = first; i < cards.size(); ++i) {
+            cards[i]->setPosition(position.x + (i > 0 ? xOffset : 0.0f), position.y);
+        }
         // Карты в сбросе всегда лицом вверх (управление этим происходит в другом месте)
     }
+
+    size_t cardAt(const std::vector<std::shared_ptr<Card>>& cards, const sf::Vector2f& point) const override {
+        // Видны верхняя карта и край нижней
+        size_t index = topCardAt(cards, point);
+        if (index == cards.size() && cards.size() > 1 && covers(*cards.front(), point)) {
+            index = 0;
+        }
+        return index;
+    }
 };
 
 class FoundationLayoutStrategy : public LayoutStrategy {
 public:
-    void layout(std::shared_ptr<Card> card, size_t index, const sf::Vector2f& basePos) override {
+    void layout(const std::vector<std::shared_ptr<Card>>& cards, size_t first, const sf::Vector2f& basePos) override {
         // Карты лежат стопкой друг на друге без смещения
-        card->setPosition(basePos.x + CARD_WIDTH_VISUAL/2.0f,
-                         basePos.y + CARD_HEIGHT_VISUAL/2.0f);
+        const sf::Vector2f position(basePos.x + CARD_WIDTH_VISUAL/2.0f, basePos.y + CARD_HEIGHT_VISUAL/2.0f);
+        for (size_t i = first; i < cards.size(); ++i) {
+            cards[i]->setPosition(position);
+        }
         // Карты в базах всегда лицом вверх (управление этим происходит в другом месте)
     }
+
+    size_t cardAt(const std::vector<std::shared_ptr<Card>>& cards, const sf::Vector2f& point) const override {
+        return topCardAt(cards, point);
+    }
 };
 
 class TableauLayoutStrategy : public LayoutStrategy {
 public:
-    void layout(std::shared_ptr<Card> card, size_t index, const sf::Vector2f& basePos) override {
+    static constexpr float Y_OFFSET = 30.0f;
+
+    void layout(const std::vector<std::shared_ptr<Card>>& cards, size_t first, const sf::Vector2f& basePos) override {
         // Карты размещаются каскадом сверху вниз
-        const float yOffset = 30.0f;
-        card->setPosition(basePos.x + CARD_WIDTH_VISUAL/2.0f,
-                         basePos.y + CARD_HEIGHT_VISUAL/2.0f + index * yOffset);
+        const float yOffset = Y_OFFSET;
+        const float x = basePos.x + CARD_WIDTH_VISUAL/2.0f;
+        const float y = basePos.y + CARD_HEIGHT_VISUAL/2.0f;
+        for (size_t i = first; i < cards.size(); ++i) {
+            cards[i]->setPosition(x, y + i * yOffset);
+        }
         // Не меняем статус лицом/рубашкой - он зависит от правил игры
     }
+
+    size_t cardAt(const std::vector<std::shared_ptr<Card>>& cards, const sf::Vector2f& point) const override {
+        if (cards.empty()) {
+            return cards.size();
+        }
+        // Верхняя из накрывающих - последняя, чей верхний край выше точки
+        float row = (point.y - cards.front()->getBounds().top) / Y_OFFSET;
+        if (row < 0.0f) {
+            return cards.size();
+        }
+        size_t index = std::min(cards.size() - 1, static_cast<size_t>(row));
+        // Точка ровно на краю карты: при округлении могла достаться соседняя
+        if (index + 1 < cards.size() && covers(*cards[index + 1], point)) {
+            return index + 1;
+        }
+        if (covers(*cards[index], point)) {
+            return index;
+        }
+        if (index > 0 && covers(*cards[index - 1], point)) {
+            return index - 1;
+        }
+        return cards.size();
+    }
 };
 
 // Конкретные реализации стратегий для валидации карт (паттерн Стратегия)
@@ -0,0 +1,48 @@
+#ifndef RENDER_SCHEDULER_HPP
+#define RENDER_SCHEDULER_HPP
+
+#include <SFML/System.hpp>
+#include <SFML/Window.hpp>
+
+// Решает, нужен ли кадр. Кадр рисуется, если что-то пометило его
+// (событие, смена таймера или счёта) или на экране идёт анимация;
+// иначе цикл спит до события или до ближайшего заказанного срока
+// (следующая секунда таймера), а не перерисовывает стол 60 раз в секунду.
+//
+// В SFML 2 у waitEvent нет тайм-аута, поэтому ожидание - опрос очереди
+// с короткими паузами: задержка ввода не больше POLL_INTERVAL_MS,
+// что меньше одного кадра при 60 Гц.
+class RenderScheduler {
+public:
+    static const sf::Int32 POLL_INTERVAL_MS = 4;
+
+    RenderScheduler();
+
+    // Следующий кадр нужно нарисовать
+    void invalidate() { m_dirty = true; }
+    // Анимация рисуется каждый кадр; задаётся заново на каждой итерации
+    void setAnimating(bool animating) { m_animating = animating; }
+    // Проснуться не позже чем через delay, даже без событий
+    void wakeIn(sf::Time delay);
+
+    bool needsFrame() const { return m_dirty || m_animating; }
+
+    // Первое событие итерации. Если кадр уже нужен, только проверяет очередь;
+    // иначе ждёт событие или срок из wakeIn(). false - событий нет
+    bool waitEvent(sf::Window& window, sf::Event& event);
+
+    // Время с прошлой итерации без учёта сна в ожидании
+    sf::Time beginFrame();
+    void frameRendered() { m_dirty = false; }
+
+private:
+    sf::Clock m_clock;       // Общая шкала для сроков
+    sf::Time m_frameStart;
+    sf::Time m_idle;         // Сколько проспали с начала прошлой итерации
+    sf::Time m_deadline;
+    bool m_hasDeadline;
+    bool m_dirty;
+    bool m_animating;
+};
+
+#endif // RENDER_SCHEDULER_HPP
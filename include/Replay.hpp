@@ -0,0 +1,96 @@
+#ifndef REPLAY_HPP
+#define REPLAY_HPP
+
+#include "Board.hpp"
+#include "MoveGenerator.hpp"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Запись партии: номер раздачи и шаги игрока с отметками времени.
+// Формат файла (little-endian), дописывается по ходу партии:
+//   заголовок 16 байт: "KRPL", uint32 версия, uint32 номер раздачи,
+//   uint8 карт за взятие, uint8 шагов между снимками, 2 байта резерв;
+//   затем записи, каждая начинается с байта вида:
+//     'M' ход и 'U' отмена хода: from, to, count, flags, uint32 мс от начала;
+//     'C' снимок: uint32 номер шага, позиция Board перед этим шагом.
+// Первая запись - снимок начальной позиции, дальше снимок через каждые
+// CHECKPOINT_INTERVAL шагов, поэтому переход к любому шагу - это копия снимка
+// и не больше CHECKPOINT_INTERVAL - 1 применённых ходов. Оборванный хвост
+// (игра закрылась посреди записи) при чтении отбрасывается.
+
+// Шаг партии: сделанный ход (в том числе повтор) или отмена хода
+struct ReplayStep {
+    Move move;                // Для отмены - отменённый ход с его флагами
+    bool undo = false;
+    std::uint32_t millis = 0; // От начала записи
+};
+
+class ReplayRecorder {
+public:
+    static const char* const DEFAULT_PATH;
+    static const int CHECKPOINT_INTERVAL = 64;
+
+    ReplayRecorder();
+
+    // Начинает новую запись с позиции board (старая запись закрывается)
+    bool start(const std::string& path, std::uint32_t dealNumber, const Board& board);
+    void stop();
+    bool isRecording() const { return m_file.is_open(); }
+
+    // Ход в том виде, в каком его выполнила игра (с флагом FLIPPED)
+    void recordMove(const Move& move);
+    void recordUndo(const Move& move);
+
+    std::uint32_t getStepCount() const { return m_stepCount; }
+
+private:
+    void writeStep(char kind, const Move& move);
+    void writeCheckpoint();
+
+    std::ofstream m_file;
+    Board m_board; // Позиция после записанных шагов - для снимков
+    std::uint32_t m_stepCount;
+    std::chrono::steady_clock::time_point m_startTime;
+};
+
+class ReplayPlayer {
+public:
+    ReplayPlayer();
+
+    // Читает запись целиком и проверяет шаги по правилам; повреждённый хвост
+    // отбрасывается. false, если файл не открылся или заголовок неверный
+    bool open(const std::string& path);
+
+    std::uint32_t getDealNumber() const { return m_dealNumber; }
+    int getDrawCount() const { return m_drawCount; }
+    std::size_t getStepCount() const { return m_steps.size(); }
+    const ReplayStep& getStep(std::size_t index) const { return m_steps[index]; }
+    std::size_t getCheckpointCount() const { return m_checkpoints.size(); }
+
+    // Позиция перед шагом getPosition(); getPosition() == getStepCount() - конец записи
+    std::size_t getPosition() const { return m_position; }
+    const Board& getBoard() const { return m_board; }
+
+    // Переход к позиции перед шагом step (не дальше конца записи)
+    void seek(std::size_t step);
+    bool stepForward();
+    bool stepBackward();
+
+private:
+    void validate();
+    void applyStep(const ReplayStep& step);
+
+    std::uint32_t m_dealNumber;
+    int m_drawCount;
+    std::vector<ReplayStep> m_steps;
+    std::vector<std::pair<std::size_t, Board>> m_checkpoints; // По возрастанию шага
+    Board m_board;
+    std::size_t m_position;
+};
+
+#endif // REPLAY_HPP
@@ -0,0 +1,65 @@
+#ifndef SAVE_FORMAT_HPP
+#define SAVE_FORMAT_HPP
+
+#include "BinaryIO.hpp"
+#include "Board.hpp"
+#include "MoveGenerator.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Содержимое сохранения: позиция, таймер, счёт, счётчики партии и ходы,
+// которые можно отменить
+struct SaveData {
+    Board board;
+    std::uint32_t dealNumber = 0;
+    std::uint32_t seconds = 0;
+    std::int32_t score = 0;
+    std::uint32_t sequence = 0; // Последняя запись журнала (GameJournal), вошедшая в сохранение
+    std::uint32_t moves = 0;    // Ходов с начала партии (не только тех, что в history)
+    std::uint16_t undos = 0;
+    std::uint16_t hints = 0;
+    std::vector<Move> history;  // От старого к последнему
+};
+
+enum class SaveError {
+    NONE,
+    TRUNCATED,      // Файл короче заголовка или длины из заголовка
+    NOT_FOUND,      // Файл не открылся
+    BAD_MAGIC,      // Не файл сохранения (в том числе старый формат)
+    FUTURE_VERSION, // Сохранено более новой версией игры
+    BAD_CHECKSUM,
+    BAD_DATA        // Контрольная сумма сошлась, но позиция или ходы невозможны
+};
+
+// Формат файла: заголовок 12 байт - "KSAV", uint8 версия, uint8 резерв,
+// uint16 длина данных, uint32 CRC-32 данных (little-endian);
+// затем данные, упакованные по битам (младшие биты первыми):
+//   32 номер раздачи, 24 секунды, 32 счёт, 32 номер записи журнала
+//   (с версии 2), 24 ходов, 16 отмен, 16 подсказок (с версии 3), 1 взятие по 3;
+//   5 размер talon, 5 размер сброса, по 6 на карту talon;
+//   4 x 6 верхние карты баз (63 - пусто);
+//   на игровую стопку 5 размер, 3 закрытых карт, по 6 на карту;
+//   15 число ходов истории, по 14 на ход: 4 откуда, 4 куда, 5 карт, 1 открылась карта.
+// Позиция с таймером, счётом и счётчиками - не больше 75 байт данных (87 байт файла).
+// Сохранения версий 1 и 2 читаются, недостающие поля - нули.
+const std::uint8_t SAVE_FORMAT_VERSION = 3;
+const std::size_t SAVE_HEADER_SIZE = 12;
+const std::size_t SAVE_MAX_FILE_SIZE = SAVE_HEADER_SIZE + 0xFFFF;
+
+// false, если позицию или историю нельзя записать в формат
+bool encodeSave(const SaveData& data, std::vector<unsigned char>& out);
+
+// Проверяет заголовок, контрольную сумму, границы всех полей, целостность
+// позиции и то, что история - цепочка допустимых ходов, ведущая в неё
+SaveError decodeSave(const unsigned char* bytes, std::size_t size, SaveData& data);
+
+const char* saveErrorText(SaveError error);
+
+// Запись через writeFileAtomic(): сбой посреди записи оставляет прежнее сохранение
+bool writeSaveFile(const std::string& path, const SaveData& data);
+// Файл читается одним вызовом и проверяется decodeSave()
+SaveError readSaveFile(const std::string& path, SaveData& data);
+
+#endif // SAVE_FORMAT_HPP
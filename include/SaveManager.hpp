@@ -2,7 +2,11 @@
 #define SAVE_MANAGER_HPP
 
 #include "Game.hpp"
+#include "GameJournal.hpp"
+#include "SaveFormat.hpp"
+#include <algorithm>
 #include <fstream>
+#include <iostream>
 #include <string>
 #include <vector>
 #include <memory>
@@ -16,122 +20,51 @@ public:
     }
 
     bool saveGame(const Game& game, const std::string& filename = "savegame.dat") {
-        std::ofstream file(filename, std::ios::binary);
-        if (!file.is_open()) {
-            return false;
-        }
-
-        // Сохраняем количество стопок
-        size_t pileCount = game.getPileCount();
-        file.write(reinterpret_cast<const char*>(&pileCount), sizeof(pileCount));
-
-        // Сохраняем каждую стопку
-        for (size_t i = 0; i < pileCount; ++i) {
-            const auto& pile = game.getPile(i);
-
-            // Сохраняем тип стопки
-            PileType type = pile->getType();
-            file.write(reinterpret_cast<const char*>(&type), sizeof(type));
-
-            // Сохраняем позицию стопки
-            sf::Vector2f position = pile->getPosition();
-            file.write(reinterpret_cast<const char*>(&position), sizeof(position));
-
-            // Сохраняем количество карт в стопке
-            size_t cardCount = pile->getCardCount();
-            file.write(reinterpret_cast<const char*>(&cardCount), sizeof(cardCount));
-
-            // Сохраняем каждую карту
-            for (size_t j = 0; j < cardCount; ++j) {
-                const auto& card = pile->getCardAt(j);
-
-                // Сохраняем масть и ранг
-                Suit suit = card->getSuit();
-                Rank rank = card->getRank();
-                bool faceUp = card->isFaceUp();
-
-                file.write(reinterpret_cast<const char*>(&suit), sizeof(suit));
-                file.write(reinterpret_cast<const char*>(&rank), sizeof(rank));
-                file.write(reinterpret_cast<const char*>(&faceUp), sizeof(faceUp));
-            }
-        }
-
-        file.close();
-        return true;
+        return writeSaveFile(filename, game.makeSaveData());
     }
 
+    // Файл читается одним вызовом и проверяется целиком до того, как
+    // текущая игра будет тронута; повреждённые и более новые сохранения отклоняются
     bool loadGame(Game& game, const std::string& filename = "savegame.dat") {
-        std::ifstream file(filename, std::ios::binary);
-        if (!file.is_open()) {
+        SaveData data;
+        SaveError error = readSaveFile(filename, data);
+        if (error != SaveError::NONE) {
+            if (error != SaveError::NOT_FOUND) {
+                std::cerr << "Сохранение отклонено: " << saveErrorText(error) << std::endl;
+            }
             return false;
         }
+        return game.restoreSaveData(data);
+    }
 
-        // Сбрасываем текущую игру
-        game.reset();
-
-        // Очищаем все стопки
-        for (size_t i = 0; i < game.getPileCount(); ++i) {
-            auto pile = game.getPile(i);
-            while (!pile->isEmpty()) {
-                pile->removeTopCard();
-            }
+    // При запуске: если прошлый сеанс оборвался, продолжает партию со
+    // снимка журнала и его хвоста, когда они новее сохранения. Затем включает
+    // журнал для текущей партии. true, если партия восстановлена
+    bool recoverGame(Game& game, const std::string& filename = "savegame.dat") {
+        SaveData saved;
+        bool hasSave = readSaveFile(filename, saved) == SaveError::NONE;
+
+        SaveData data = saved;
+        bool hasBase = hasSave;
+        SaveData snapshot;
+        if (readSaveFile(GameJournal::DEFAULT_SNAPSHOT_PATH, snapshot) == SaveError::NONE &&
+            (!hasBase || snapshot.sequence > data.sequence)) {
+            data = snapshot;
+            hasBase = true;
         }
-
-        // Загружаем количество стопок
-        size_t pileCount;
-        file.read(reinterpret_cast<char*>(&pileCount), sizeof(pileCount));
-
-        // Проверяем, совпадает ли количество стопок
-        if (pileCount != game.getPileCount()) {
-            file.close();
-            return false;
+        if (GameJournal::recover(GameJournal::DEFAULT_JOURNAL_PATH, data, hasBase) > 0) {
+            hasBase = true;
         }
 
-        // Загружаем каждую стопку
-        for (size_t i = 0; i < pileCount; ++i) {
-            auto pile = game.getPile(i);
-
-            // Загружаем тип стопки
-            PileType type;
-            file.read(reinterpret_cast<char*>(&type), sizeof(type));
-
-            // Проверяем, совпадает ли тип стопки
-            if (type != pile->getType()) {
-                file.close();
-                return false;
-            }
-
-            // Загружаем позицию стопки
-            sf::Vector2f position;
-            file.read(reinterpret_cast<char*>(&position), sizeof(position));
-
-            // Загружаем количество карт в стопке
-            size_t cardCount;
-            file.read(reinterpret_cast<char*>(&cardCount), sizeof(cardCount));
-
-            // Загружаем каждую карту
-            for (size_t j = 0; j < cardCount; ++j) {
-                // Загружаем масть и ранг
-                Suit suit;
-                Rank rank;
-                bool faceUp;
-
-                file.read(reinterpret_cast<char*>(&suit), sizeof(suit));
-
-                file.read(reinterpret_cast<char*>(&rank), sizeof(rank));
-                file.read(reinterpret_cast<char*>(&faceUp), sizeof(faceUp));
-
-                // Создаем карту и добавляем ее в стопку
-                auto card = std::make_shared<Card>(suit, rank);
-                if (faceUp) {
-                    card->flip();
-                }
-                pile->addCard(card);
-            }
+        // Законченную партию не продолжаем
+        bool recovered = hasBase && (!hasSave || data.sequence > saved.sequence) && !data.board.isWon() &&
+                         game.restoreSaveData(data);
+        if (recovered) {
+            std::cout << "Восстановлена партия, прерванная сбоем" << std::endl;
         }
 
-        file.close();
-        return true;
+        game.startJournal(hasBase ? std::max(data.sequence, saved.sequence) : 0);
+        return recovered;
     }
 
     bool saveExists(const std::string& filename = "savegame.dat") {
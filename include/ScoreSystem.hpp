@@ -74,6 +74,16 @@ public:
         return m_score;
     }
 
+    // Восстановление счета сохранённой партии
+    void setScore(int score) {
+        m_score = score;
+
+        // Уведомляем об изменении счета
+        if (m_scoreCallback) {
+            m_scoreCallback(m_score);
+        }
+    }
+
     // Сброс счета
     void reset() {
         m_score = 0;
@@ -0,0 +1,97 @@
+#ifndef SELF_PLAY_HPP
+#define SELF_PLAY_HPP
+
+#include "Board.hpp"
+#include "Deal.hpp"
+#include "MoveGenerator.hpp"
+#include "Solver.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Стратегия игры без окна: по позиции и списку допустимых ходов выбирает ход
+class PlayPolicy {
+public:
+    virtual ~PlayPolicy() = default;
+
+    virtual const char* getName() const = 0;
+
+    // Вызывается перед каждой партией
+    virtual void startGame(const Board& board) { (void)board; }
+
+    // Индекс хода в moves или -1, чтобы сдаться. moves не пуст
+    virtual int chooseMove(const Board& board, const MoveList& moves) = 0;
+};
+
+// Случайный допустимый ход
+class RandomPolicy : public PlayPolicy {
+public:
+    explicit RandomPolicy(std::uint64_t seed) : m_random(seed) {}
+
+    const char* getName() const override { return "random"; }
+    int chooseMove(const Board& board, const MoveList& moves) override;
+
+private:
+    DealRandom m_random;
+};
+
+// Лучший ход по приоритету подсказки (hintPriority); бесполезные
+// перекладывания между стопками не делает, иначе берёт из колоды
+class GreedyPolicy : public PlayPolicy {
+public:
+    const char* getName() const override { return "greedy"; }
+    int chooseMove(const Board& board, const MoveList& moves) override;
+};
+
+// Играет найденное решателем решение; если его нет - как GreedyPolicy
+class SolverPolicy : public PlayPolicy {
+public:
+    explicit SolverPolicy(const SolverLimits& limits = SolverLimits());
+
+    const char* getName() const override { return "solver"; }
+    void startGame(const Board& board) override;
+    int chooseMove(const Board& board, const MoveList& moves) override;
+
+private:
+    Solver m_solver;
+    GreedyPolicy m_fallback;
+    std::vector<Move> m_plan;
+    std::size_t m_step;
+};
+
+// "random", "greedy" или "solver"; nullptr для неизвестного имени
+std::unique_ptr<PlayPolicy> makePlayPolicy(const std::string& name, std::uint64_t seed,
+                                           const SolverLimits& limits = SolverLimits());
+
+// Итог одной партии
+struct GameRecord {
+    std::uint32_t dealNumber = 0;
+    bool won = false;
+    int moves = 0;           // Сделано ходов, включая взятие из колоды
+    int foundationCards = 0; // Карт собрано в базах
+    double seconds = 0.0;
+};
+
+// Сводка по серии партий
+struct SelfPlayStats {
+    std::uint64_t games = 0;
+    std::uint64_t wins = 0;
+    std::uint64_t moves = 0;
+    std::uint64_t foundationCards = 0;
+    double seconds = 0.0; // Суммарное время партий
+
+    void add(const GameRecord& record);
+    void merge(const SelfPlayStats& other);
+
+    double winRate() const { return games ? static_cast<double>(wins) / games : 0.0; }
+    double averageMoves() const { return games ? static_cast<double>(moves) / games : 0.0; }
+    double gamesPerSecond() const { return seconds > 0.0 ? games / seconds : 0.0; }
+};
+
+// Играет раздачу до победы, отказа стратегии, лимита ходов или двух
+// переворотов сброса подряд без единого другого хода (дальше игра не сдвинется)
+GameRecord playGame(std::uint32_t dealNumber, PlayPolicy& policy, int drawCount = 1, int maxMoves = 2000);
+
+#endif // SELF_PLAY_HPP
@@ -0,0 +1,96 @@
+#ifndef SOLVER_HPP
+#define SOLVER_HPP
+
+#include "Board.hpp"
+#include "MoveGenerator.hpp"
+#include "TranspositionTable.hpp"
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+// Вердикт решателя
+enum class SolveResult {
+    WINNABLE,   // Найдена выигрышная последовательность
+    UNWINNABLE, // Перебор завершён, выигрыша нет
+    UNKNOWN     // Исчерпан бюджет узлов или времени
+};
+
+// Ограничения поиска (0 - без ограничения)
+struct SolverLimits {
+    std::uint64_t maxNodes = 2000000;
+    double maxSeconds = 1.0;
+
+    // Таблица просмотренных позиций
+    std::size_t tableBytes = 16u << 20;
+    ReplacementPolicy replacement = ReplacementPolicy::KEEP_SHALLOWEST;
+};
+
+struct Solution {
+    SolveResult result = SolveResult::UNKNOWN;
+    std::vector<Move> moves; // Ходы до победы для WINNABLE, включая взятие из колоды
+    std::uint64_t nodes = 0;
+    double seconds = 0.0;
+    TranspositionStats table;
+};
+
+// Решатель Косынки: поиск в глубину с упорядочиванием ходов и отсечениями.
+// Решатель видит закрытые карты, поэтому вердикт относится к раздаче,
+// а не к тому, как её сыграет человек. Работает с Board::drawCount 1 и 3.
+//
+// Чтобы не перебирать цепочки «взять карту», ходы из колоды объединены:
+// одним ходом берётся любая достижимая карта колоды (с переворотом сброса,
+// если нужно) и сразу кладётся на место. В решении такой ход
+// разворачивается в обычные ходы MoveGenerator.
+//
+// Отсечения: безопасные ходы в базы делаются сразу, пустые стопки
+// равноценны, карты из баз не возвращаются, часть последовательности
+// переносится только ради хода в базу. Последние два правила сужают
+// перебор, поэтому UNWINNABLE означает «нет решения среди таких ходов».
+class Solver {
+public:
+    explicit Solver(const SolverLimits& limits = SolverLimits());
+
+    Solution solve(const Board& board);
+
+    // Карту можно без потерь отправить в базу: карты, которым она могла бы
+    // служить основанием в игровых стопках, уже собраны
+    static bool isSafeToFoundation(const Board& board, CardId card);
+
+    // Ход-кандидат: обычный ход или карта из колоды (talonIndex != NO_TALON)
+    struct Candidate {
+        Move move;
+        std::uint8_t talonIndex;
+        bool recycle; // Перед взятием нужно перевернуть сброс
+        int score;
+    };
+
+    static const std::uint8_t NO_TALON = 0xFF;
+    static const int MAX_CANDIDATES = 256;
+    // Глубже не спускаемся, чтобы не переполнить стек; ветка тогда не
+    // досчитана, и отсутствие решения даёт UNKNOWN
+    static const int MAX_DEPTH = 400;
+
+    // Шаги поиска, общие для последовательного и параллельного решателя.
+    // Сделанные ходы дописываются в path, hash (zobristHash) обновляется
+    static void autoPlay(Board& board, std::vector<Move>& path, std::uint64_t& hash);
+    static int collectCandidates(const Board& board, Candidate* candidates);
+    static void playCandidate(Board& board, const Candidate& candidate, std::vector<Move>& path,
+                              std::uint64_t& hash);
+
+    const TranspositionTable& getTable() const { return m_table; }
+
+private:
+    bool search(const Board& position, std::uint64_t hash, int depth);
+    bool outOfBudget();
+
+    SolverLimits m_limits;
+    TranspositionTable m_table;
+    bool m_tableUsed;
+    std::vector<Move> m_path;
+    std::uint64_t m_nodes;
+    bool m_aborted;
+    bool m_depthLimited;
+    std::chrono::steady_clock::time_point m_startTime;
+};
+
+#endif // SOLVER_HPP
@@ -0,0 +1,110 @@
+#ifndef STATS_LOG_HPP
+#define STATS_LOG_HPP
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Структура для хранения статистики
+struct GameStats {
+    int gamesPlayed = 0;
+    int gamesWon = 0;
+    int totalMoves = 0;
+    int totalCards = 0;
+    int fastestWin = 999999; // Время в секундах
+    int bestScore = 0;
+
+    // Статистика текущей игры
+    int currentMoves = 0;
+    int currentTime = 0;
+    int currentScore = 0;
+};
+
+enum class StatsEventType : std::uint8_t {
+    GAME_STARTED = 1,
+    MOVE = 2,
+    GAME_WON = 3,   // Победа обнаружена на столе
+    GAME_OVER = 4,  // Партия засчитана: won, ходы, время, счёт
+    ACHIEVEMENT = 5 // Открыто достижение (value - CRC-32 его id)
+};
+
+struct StatsEvent {
+    StatsEventType type = StatsEventType::MOVE;
+    bool won = false;
+    std::uint32_t value = 0; // Ходы для GAME_OVER, CRC-32 id для ACHIEVEMENT
+    std::uint32_t seconds = 0;
+    std::int32_t score = 0;
+};
+
+// Сводка, которая строится из событий: статистика и открытые достижения
+struct StatsSummary {
+    GameStats stats;
+    std::vector<std::string> unlocked;
+};
+
+// Одно правило свёртки для живой статистики и для восстановления из журнала
+void applyStatsEvent(GameStats& stats, const StatsEvent& event);
+
+StatsEvent achievementEvent(const std::string& id);
+
+// Статистика как журнал событий только на дозапись. Главный поток лишь
+// складывает события в память; фоновый поток дописывает их в журнал
+// (один fsync на пачку) и, накопив COMPACT_EVENTS событий, сворачивает
+// их в снимок - stats.json прежнего вида с номером последнего события -
+// после чего начинает журнал заново.
+//
+// Журнал: заголовок 8 байт "KSTL", uint32 версия; записи по 24 байта
+//   uint8 вид, uint8 won, 2 байта резерв, uint32 value, uint32 секунды,
+//   int32 счёт, uint32 номер события, uint32 CRC-32 первых 20 байт.
+class StatsLog {
+public:
+    static const int SYNC_INTERVAL_MS = 500;
+    static const std::uint32_t COMPACT_EVENTS = 256;
+
+    StatsLog();
+    ~StatsLog();
+    StatsLog(const StatsLog&) = delete;
+    StatsLog& operator=(const StatsLog&) = delete;
+
+    // Читает снимок и сворачивает хвост журнала; запускает фоновый поток
+    StatsSummary open(const std::string& snapshotPath, const std::string& logPath,
+                    const std::vector<std::string>& knownIds);
+    void close();
+
+    // Главный поток, без обращения к диску
+    void append(const StatsEvent& event);
+
+    // Свернуть всё в снимок и дождаться записи (при выходе из игры)
+    void sync();
+
+private:
+    void writerLoop();
+    bool appendRecords(const std::vector<unsigned char>& records);
+    bool compact();
+
+    std::string m_snapshotPath;
+    std::string m_logPath;
+    std::vector<std::string> m_knownIds;
+    std::uint32_t m_sequence; // Только главный поток
+
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_synced;
+    std::vector<unsigned char> m_pending;
+    bool m_syncRequested;
+    std::uint64_t m_syncCount;
+    bool m_stopping;
+
+    // Только фоновый поток
+    std::thread m_thread;
+    std::FILE* m_file;
+    StatsSummary m_state;             // Свёртка всех записанных событий
+    std::uint32_t m_stateSequence;  // Номер последнего из них
+    std::uint32_t m_sinceSnapshot;
+};
+
+#endif // STATS_LOG_HPP
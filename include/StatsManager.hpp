@@ -1,38 +1,12 @@
 #ifndef STATS_MANAGER_HPP
 #define STATS_MANAGER_HPP
 
+#include "AchievementEngine.hpp"
+#include "StatsLog.hpp"
+#include <functional>
 #include <map>
 #include <string>
 #include <vector>
-#include <fstream>
-#include <nlohmann/json.hpp> // Используем библиотеку nlohmann/json для работы с JSON
-
-// Структура для хранения статистики
-struct GameStats {
-    int gamesPlayed = 0;
-    int gamesWon = 0;
-    int totalMoves = 0;
-    int totalCards = 0;
-    int fastestWin = 999999; // Время в секундах
-    int bestScore = 0;
-
-    // Статистика текущей игры
-    int currentMoves = 0;
-    int currentTime = 0;
-    int currentScore = 0;
-};
-
-// Структура для хранения достижения
-struct Achievement {
-    std::string id;
-    std::string name;
-    std::string description;
-    bool unlocked = false;
-    std::string iconPath;
-
-    // Функция проверки выполнения условий достижения
-    std::function<bool(const GameStats&)> checkCondition;
-};
 
 // Менеджер статистики и достижений (паттерн Одиночка)
 class StatsManager {
@@ -42,163 +16,81 @@ public:
         return instance;
     }
 
-    // Загрузка статистики из файла
-    bool loadStats(const std::string& filename = "stats.json") {
-        std::ifstream file(filename);
-        if (!file.is_open()) {
-            // Если файл не существует, создаем пустую статистику
-            return false;
-        }
-
-        try {
-            nlohmann::json j;
-            file >> j;
-
-            m_stats.gamesPlayed = j["gamesPlayed"];
-            m_stats.gamesWon = j["gamesWon"];
-            m_stats.totalMoves = j["totalMoves"];
-            m_stats.totalCards = j["totalCards"];
-            m_stats.fastestWin = j["fastestWin"];
-            m_stats.bestScore = j["bestScore"];
-
-            // Загрузка достижений
-            for (auto& ach : j["achievements"]) {
-                std::string id = ach["id"];
-                for (auto& achievement : m_achievements) {
-                    if (achievement.id == id) {
-                        achievement.unlocked = ach["unlocked"];
-                        break;
-                    }
-                }
-            }
-
-            file.close();
-            return true;
-        } catch (const std::exception& e) {
-            file.close();
-            return false;
-        }
-    }
-
-    // Сохранение статистики в файл
-    bool saveStats(const std::string& filename = "stats.json") {
-        nlohmann::json j;
-
-        j["gamesPlayed"] = m_stats.gamesPlayed;
-        j["gamesWon"] = m_stats.gamesWon;
-        j["totalMoves"] = m_stats.totalMoves;
-        j["totalCards"] = m_stats.totalCards;
-        j["fastestWin"] = m_stats.fastestWin;
-        j["bestScore"] = m_stats.bestScore;
-
-        // Сохранение достижений
-        nlohmann::json achievements = nlohmann::json::array();
-        for (const auto& achievement : m_achievements) {
-            nlohmann::json ach;
-            ach["id"] = achievement.id;
-            ach["unlocked"] = achievement.unlocked;
-            achievements.push_back(ach);
-        }
-        j["achievements"] = achievements;
-
-        std::ofstream file(filename);
-        if (!file.is_open()) {
-            return false;
-        }
-
-        file << std::setw(4) << j << std::endl;
-        file.close();
+    // Загрузка статистики: снимок stats.json и события журнала после него
+    bool loadStats(const std::string& filename = "stats.json", const std::string& logFilename = "stats.log") {
+        StatsSummary state = m_log.open(filename, logFilename, m_engine.getIds());
+        m_stats = state.stats;
+        syncCounters();
+        m_engine.initialize(state.unlocked);
         return true;
     }
 
-    // Инициализация достижений
-    void initAchievements() {
-        m_achievements = {
-            {"first_win", "First Win", "Win Your First Game", false, "assets/achievements/first_win.png",
-             [](const GameStats& stats) { return stats.gamesWon > 0; }},
-
-            {"5_wins", "5terka", "Win 5 Games", false, "assets/achievements/5_wins.png",
-             [](const GameStats& stats) { return stats.gamesWon >= 5; }},
-
-            {"10_wins", "10ka", "Win 10 Games", false, "assets/achievements/10_wins.png",
-             [](const GameStats& stats) { return stats.gamesWon >= 10; }},
-
-            {"fast_win", "Fast Win", "Win Game Faster Than 3 Minutes", false, "assets/achievements/fast_win.png",
-
-             [](const GameStats& stats) { return stats.fastestWin < 180; }},
-
-            {"high_score", "Champion", "Score More Than 1000 Points", false, "assets/achievements/high_score.png",
-             [](const GameStats& stats) { return stats.bestScore > 1000; }},
-
-            {"pro_player", "Professional", "Win Game In Less Than 100 Moves", false, "assets/achievements/pro_player.png",
-             [](const GameStats& stats) { return stats.currentMoves < 100 && stats.gamesWon > stats.gamesPlayed - 1; }}
-        };
+    // Сворачивает журнал в stats.json и ждёт записи. В игре не нужен:
+    // события и так пишутся в фоне, вызывается при выходе
+    bool saveStats() {
+        m_log.sync();
+        return true;
     }
 
     // Обновление статистики при окончании игры
     void gameCompleted(bool won) {
-        m_stats.gamesPlayed++;
-
+        StatsEvent event;
+        event.type = StatsEventType::GAME_OVER;
+        event.won = won;
+        event.value = static_cast<std::uint32_t>(m_stats.currentMoves);
+        event.seconds = static_cast<std::uint32_t>(m_stats.currentTime);
+        event.score = m_stats.currentScore;
+
+        // Итоги партии - до того, как событие сбросит текущую статистику
         if (won) {
-            m_stats.gamesWon++;
-            m_stats.totalMoves += m_stats.currentMoves;
-
-            // Обновляем лучшее время
-            if (m_stats.currentTime < m_stats.fastestWin) {
-                m_stats.fastestWin = m_stats.currentTime;
-            }
-
-            // Обновляем лучший счет
-            if (m_stats.currentScore > m_stats.bestScore) {
-                m_stats.bestScore = m_stats.currentScore;
-            }
-
-            // Проверяем достижения
-            checkAchievements();
+            m_engine.set(StatCounter::LAST_WIN_MOVES, m_stats.currentMoves);
+            m_engine.set(StatCounter::LAST_WIN_SECONDS, m_stats.currentTime);
+            m_engine.set(StatCounter::LAST_WIN_SCORE, m_stats.currentScore);
         }
-
-        // Сбрасываем текущую статистику
-        m_stats.currentMoves = 0;
-        m_stats.currentTime = 0;
-        m_stats.currentScore = 0;
-
-        // Сохраняем статистику
-        saveStats();
+        record(event);
+        checkAchievements();
     }
 
     // Увеличение счетчика побед (добавлено)
     void incrementWins() {
-        m_stats.gamesWon++;
+        StatsEvent event;
+        event.type = StatsEventType::GAME_WON;
+        record(event);
         // Проверяем достижения
         checkAchievements();
-        // Сохраняем статистику
-        saveStats();
     }
 
-    // Проверка и разблокировка достижений
+    // Проверка достижений, зависящих от изменившихся счётчиков
     void checkAchievements() {
-        bool newAchievements = false;
-
-        for (auto& achievement : m_achievements) {
-            if (!achievement.unlocked && achievement.checkCondition(m_stats)) {
-                achievement.unlocked = true;
-                newAchievements = true;
+        const std::vector<Achievement>& achievements = m_engine.getAchievements();
+        for (std::size_t index : m_engine.evaluate()) {
+            m_log.append(achievementEvent(achievements[index].id));
 
-                // Уведомляем о новом достижении
-                if (m_achievementCallback) {
-                    m_achievementCallback(achievement);
-                }
+            // Уведомляем о новом достижении
+            if (m_achievementCallback) {
+                m_achievementCallback(achievements[index]);
             }
         }
+    }
 
-        if (newAchievements) {
-            saveStats();
-        }
+    // Начало новой партии: счётчики текущей игры с нуля
+    void gameStarted() {
+        StatsEvent event;
+        event.type = StatsEventType::GAME_STARTED;
+        record(event);
+    }
+
+    // Продолжение сохранённой партии: счётчики текущей игры из сохранения,
+    // без события начала игры
+    void gameResumed(int moves, int seconds, int score) {
+        m_stats.currentMoves = moves;
+        m_stats.currentTime = seconds;
+        m_stats.currentScore = score;
     }
 
     // Получение списка всех достижений
     const std::vector<Achievement>& getAchievements() const {
-        return m_achievements;
+        return m_engine.getAchievements();
     }
 
     // Получение статистики
@@ -208,7 +100,9 @@ public:
 
     // Увеличение счетчика ходов
     void incrementMoves() {
-        m_stats.currentMoves++;
+        StatsEvent event;
+        event.type = StatsEventType::MOVE;
+        record(event);
     }
 
     // Установка времени текущей игры
@@ -227,16 +121,33 @@ public:
     }
 
 private:
+    // Событие сразу учитывается в памяти, на диск его пишет журнал в фоне
+    void record(const StatsEvent& event) {
+        applyStatsEvent(m_stats, event);
+        m_log.append(event);
+        syncCounters();
+    }
+
+    // Итоговые счётчики для достижений; помечаются только изменившиеся
+    void syncCounters() {
+        m_engine.set(StatCounter::GAMES_PLAYED, m_stats.gamesPlayed);
+        m_engine.set(StatCounter::GAMES_WON, m_stats.gamesWon);
+        m_engine.set(StatCounter::TOTAL_MOVES, m_stats.totalMoves);
+        m_engine.set(StatCounter::FASTEST_WIN, m_stats.fastestWin);
+        m_engine.set(StatCounter::BEST_SCORE, m_stats.bestScore);
+    }
+
     StatsManager() {
-        initAchievements();
+        m_engine.load(AchievementEngine::DEFAULT_PATH);
         loadStats();
     }
     ~StatsManager() = default;
     StatsManager(const StatsManager&) = delete;
     StatsManager& operator=(const StatsManager&) = delete;
 
+    StatsLog m_log;
     GameStats m_stats;
-    std::vector<Achievement> m_achievements;
+    AchievementEngine m_engine;
     std::function<void(const Achievement&)> m_achievementCallback;
 };
 
@@ -0,0 +1,90 @@
+#ifndef TRANSPOSITION_TABLE_HPP
+#define TRANSPOSITION_TABLE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// Что делать, если корзина заполнена
+enum class ReplacementPolicy {
+    ALWAYS,          // Новая позиция вытесняет самую глубокую из корзины
+    KEEP_SHALLOWEST, // Вытесняет, только если она не глубже вытесняемой
+    NEVER            // Заполненная корзина не меняется, новая позиция не хранится
+};
+
+struct TranspositionStats {
+    std::uint64_t probes = 0;    // Обращений к таблице
+    std::uint64_t hits = 0;      // Позиция уже была в таблице
+    std::uint64_t stores = 0;    // Записано в свободную ячейку
+    std::uint64_t replaced = 0;  // Записано поверх другой позиции
+    std::uint64_t rejected = 0;  // Не записано из-за политики замещения
+    std::uint64_t used = 0;      // Занятых ячеек
+    std::uint64_t capacity = 0;  // Всего ячеек
+
+    double hitRate() const { return probes ? static_cast<double>(hits) / probes : 0.0; }
+    double occupancy() const { return capacity ? static_cast<double>(used) / capacity : 0.0; }
+};
+
+// Таблица уже просмотренных позиций фиксированного размера.
+// Корзина - 4 ячейки по 8 байт (половина строки кэша); ячейка хранит
+// старшие биты хэша и глубину в одном атомарном слове, поэтому
+// чтение и запись из многих потоков обходятся без блокировок.
+// Гонки допустимы: в худшем случае одна позиция будет просмотрена дважды.
+class TranspositionTable {
+public:
+    // Размер в байтах округляется вниз до степени двойки корзин
+    explicit TranspositionTable(std::size_t memoryBytes = 16u << 20,
+                                ReplacementPolicy policy = ReplacementPolicy::KEEP_SHALLOWEST);
+
+    // Отмечает позицию как просмотренную на глубине depth.
+    // Возвращает false, если она уже была в таблице
+    bool insert(std::uint64_t hash, int depth);
+
+    bool contains(std::uint64_t hash) const;
+
+    // Очищает таблицу и счётчики (не потокобезопасно)
+    void clear();
+
+    TranspositionStats getStats() const;
+    std::size_t getMemoryBytes() const { return m_bucketCount * sizeof(Bucket); }
+    ReplacementPolicy getPolicy() const { return m_policy; }
+
+private:
+    static const int BUCKET_SIZE = 4;
+    static const int DEPTH_BITS = 10;
+    static const std::uint64_t DEPTH_MASK = (1u << DEPTH_BITS) - 1;
+    static const int COUNTER_STRIPES = 64;
+
+    struct alignas(32) Bucket {
+        std::atomic<std::uint64_t> slots[BUCKET_SIZE];
+    };
+
+    // Счётчики разнесены по строкам кэша, чтобы потоки не мешали друг другу
+    struct alignas(64) Counters {
+        std::atomic<std::uint64_t> probes{0};
+        std::atomic<std::uint64_t> hits{0};
+        std::atomic<std::uint64_t> stores{0};
+        std::atomic<std::uint64_t> replaced{0};
+        std::atomic<std::uint64_t> rejected{0};
+    };
+
+    static std::uint64_t pack(std::uint64_t hash, int depth);
+    static int depthOf(std::uint64_t entry) { return static_cast<int>(entry & DEPTH_MASK) - 1; }
+    static bool sameKey(std::uint64_t entry, std::uint64_t hash) {
+        return entry != 0 && (entry & ~DEPTH_MASK) == (hash & ~DEPTH_MASK);
+    }
+
+    Bucket& bucketFor(std::uint64_t hash) const { return m_buckets[hash & m_bucketMask]; }
+    Counters& countersFor(std::uint64_t hash) const {
+        return m_counters[(hash >> 32) % COUNTER_STRIPES];
+    }
+
+    std::unique_ptr<Bucket[]> m_buckets;
+    std::size_t m_bucketCount;
+    std::uint64_t m_bucketMask;
+    ReplacementPolicy m_policy;
+    std::unique_ptr<Counters[]> m_counters;
+};
+
+#endif // TRANSPOSITION_TABLE_HPP
@@ -0,0 +1,47 @@
+#ifndef UNDO_HISTORY_HPP
+#define UNDO_HISTORY_HPP
+
+#include "MoveGenerator.hpp"
+#include <cstddef>
+#include <vector>
+
+// История ходов для отмены и повтора: кольцевой буфер записей Move
+// (4 байта: откуда, куда, сколько карт, открылась ли карта).
+// Память выделяется один раз в конструкторе; когда буфер заполнен,
+// новый ход вытесняет самый старый. Записи [начало, начало + undo) можно
+// отменить, следующие redo записей - повторить; новый ход сбрасывает повтор.
+class UndoHistory {
+public:
+    // 16384 хода - 64 КБ, заведомо больше любой партии
+    static const std::size_t DEFAULT_CAPACITY = 16384;
+
+    explicit UndoHistory(std::size_t capacity = DEFAULT_CAPACITY);
+
+    void push(const Move& move);
+    void clear();
+
+    bool canUndo() const { return m_undoCount > 0; }
+    bool canRedo() const { return m_redoCount > 0; }
+
+    // Последний сделанный ход; он становится первым для повтора
+    Move popUndo();
+    // Следующий ход для повтора; он снова становится последним сделанным
+    Move popRedo();
+
+    // Ход, который можно отменить: 0 - самый старый, getUndoCount() - 1 - последний
+    const Move& getUndoMove(std::size_t index) const { return m_moves[slot(index)]; }
+
+    std::size_t getUndoCount() const { return m_undoCount; }
+    std::size_t getRedoCount() const { return m_redoCount; }
+    std::size_t getCapacity() const { return m_moves.size(); }
+
+private:
+    std::size_t slot(std::size_t offset) const { return (m_start + offset) % m_moves.size(); }
+
+    std::vector<Move> m_moves;
+    std::size_t m_start;     // Самый старый ход, который ещё можно отменить
+    std::size_t m_undoCount;
+    std::size_t m_redoCount;
+};
+
+#endif // UNDO_HISTORY_HPP
@@ -0,0 +1,21 @@
+#ifndef ZOBRIST_HPP
+#define ZOBRIST_HPP
+
+#include "Board.hpp"
+#include "MoveGenerator.hpp"
+#include <cstdint>
+
+// Хэш Зобриста позиции Board.
+//
+// Каждая карта игровой стопки даёт ключ по тройке (карта, карта под ней,
+// открыта ли), поэтому хэш не зависит от порядка стопок, но различает,
+// что на чём лежит. Колода - XOR ключей оставшихся в ней карт (их порядок
+// не меняется) плюс ключ положения в колоде при взятии по три; при взятии
+// по одной положение не важно для решателя и в хэш не входит.
+// Базы - ключи верхних карт.
+std::uint64_t zobristHash(const Board& board);
+
+// Хэш после хода за O(1): before - позиция до хода, hash - её хэш
+std::uint64_t zobristUpdate(std::uint64_t hash, const Board& before, const Move& move);
+
+#endif // ZOBRIST_HPP
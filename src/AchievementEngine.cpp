@@ -0,0 +1,211 @@
+#include "AchievementEngine.hpp"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <nlohmann/json.hpp>
+
+const char* const AchievementEngine::DEFAULT_PATH = "assets/achievements.json";
+
+const char* AchievementEngine::counterName(StatCounter counter) {
+    switch (counter) {
+    case StatCounter::GAMES_PLAYED:
+        return "gamesPlayed";
+    case StatCounter::GAMES_WON:
+        return "gamesWon";
+    case StatCounter::TOTAL_MOVES:
+        return "totalMoves";
+    case StatCounter::FASTEST_WIN:
+        return "fastestWin";
+    case StatCounter::BEST_SCORE:
+        return "bestScore";
+    case StatCounter::LAST_WIN_MOVES:
+        return "lastWinMoves";
+    case StatCounter::LAST_WIN_SECONDS:
+        return "lastWinSeconds";
+    case StatCounter::LAST_WIN_SCORE:
+        return "lastWinScore";
+    case StatCounter::COUNT:
+        break;
+    }
+    return "";
+}
+
+static bool parseCounter(const std::string& name, StatCounter& counter) {
+    for (int i = 0; i < static_cast<int>(StatCounter::COUNT); ++i) {
+        if (name == AchievementEngine::counterName(static_cast<StatCounter>(i))) {
+            counter = static_cast<StatCounter>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool parseOp(const std::string& name, AchievementCondition::Op& op) {
+    using Op = AchievementCondition::Op;
+    static const std::pair<const char*, Op> ops[] = {
+        {"<", Op::LESS}, {"<=", Op::LESS_EQUAL}, {">", Op::GREATER}, {">=", Op::GREATER_EQUAL}, {"==", Op::EQUAL}};
+    for (const auto& entry : ops) {
+        if (name == entry.first) {
+            op = entry.second;
+            return true;
+        }
+    }
+    return false;
+}
+
+AchievementEngine::AchievementEngine() : m_values(), m_known(0), m_dirty(0), m_epoch(0) {
+}
+
+bool AchievementEngine::load(const std::string& path) {
+    m_achievements.clear();
+    for (auto& list : m_byCounter) {
+        list.clear();
+    }
+
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "Не удалось открыть файл достижений: " << path << std::endl;
+        return false;
+    }
+    nlohmann::json j;
+    try {
+        file >> j;
+    } catch (const std::exception& e) {
+        std::cerr << "Ошибка в файле достижений " << path << ": " << e.what() << std::endl;
+        return false;
+    }
+
+    for (const auto& entry : j.value("achievements", nlohmann::json::array())) {
+        try {
+            Achievement achievement;
+            achievement.id = entry.at("id").get<std::string>();
+            achievement.name = entry.value("name", achievement.id);
+            achievement.description = entry.value("description", "");
+            achievement.iconPath = entry.value("icon", "");
+            for (const auto& clause : entry.at("when")) {
+                AchievementCondition condition;
+                if (!parseCounter(clause.at("counter").get<std::string>(), condition.counter) ||
+                    !parseOp(clause.at("op").get<std::string>(), condition.op)) {
+                    throw std::runtime_error("неизвестный счётчик или операция");
+                }
+                condition.value = clause.at("value").get<std::int64_t>();
+                achievement.conditions.push_back(condition);
+            }
+            if (achievement.conditions.empty()) {
+                throw std::runtime_error("нет условий");
+            }
+            m_achievements.push_back(std::move(achievement));
+        } catch (const std::exception& e) {
+            std::cerr << "Достижение пропущено: " << e.what() << std::endl;
+        }
+    }
+
+    m_checkedAt.assign(m_achievements.size(), 0);
+    for (std::size_t i = 0; i < m_achievements.size(); ++i) {
+        for (const AchievementCondition& condition : m_achievements[i].conditions) {
+            std::vector<std::size_t>& list = m_byCounter[static_cast<int>(condition.counter)];
+            if (list.empty() || list.back() != i) {
+                list.push_back(i);
+            }
+        }
+    }
+    return true;
+}
+
+void AchievementEngine::initialize(const std::vector<std::string>& unlockedIds) {
+    for (std::size_t i = 0; i < m_achievements.size(); ++i) {
+        Achievement& achievement = m_achievements[i];
+        achievement.unlocked = std::find(unlockedIds.begin(), unlockedIds.end(), achievement.id) != unlockedIds.end();
+        if (achievement.unlocked) {
+            unindex(i);
+        }
+    }
+    m_dirty = 0;
+}
+
+void AchievementEngine::set(StatCounter counter, std::int64_t value) {
+    std::uint32_t bit = 1u << static_cast<int>(counter);
+    if ((m_known & bit) && m_values[static_cast<int>(counter)] == value) {
+        return;
+    }
+    m_values[static_cast<int>(counter)] = value;
+    m_known |= bit;
+    m_dirty |= bit;
+}
+
+bool AchievementEngine::holds(const Achievement& achievement) const {
+    for (const AchievementCondition& condition : achievement.conditions) {
+        int counter = static_cast<int>(condition.counter);
+        if (!(m_known & (1u << counter))) {
+            return false;
+        }
+        std::int64_t value = m_values[counter];
+        bool result = false;
+        switch (condition.op) {
+        case AchievementCondition::Op::LESS:
+            result = value < condition.value;
+            break;
+        case AchievementCondition::Op::LESS_EQUAL:
+            result = value <= condition.value;
+            break;
+        case AchievementCondition::Op::GREATER:
+            result = value > condition.value;
+            break;
+        case AchievementCondition::Op::GREATER_EQUAL:
+            result = value >= condition.value;
+            break;
+        case AchievementCondition::Op::EQUAL:
+            result = value == condition.value;
+            break;
+        }
+        if (!result) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::vector<std::size_t> AchievementEngine::evaluate() {
+    std::vector<std::size_t> unlocked;
+    if (m_dirty == 0) {
+        return unlocked;
+    }
+    ++m_epoch;
+    for (int counter = 0; counter < COUNTER_COUNT; ++counter) {
+        if (!(m_dirty & (1u << counter))) {
+            continue;
+        }
+        for (std::size_t index : m_byCounter[counter]) {
+            if (m_checkedAt[index] == m_epoch) {
+                continue;
+            }
+            m_checkedAt[index] = m_epoch;
+            if (holds(m_achievements[index])) {
+                unlocked.push_back(index);
+            }
+        }
+    }
+    m_dirty = 0;
+
+    // Открытые больше не проверяются
+    for (std::size_t index : unlocked) {
+        m_achievements[index].unlocked = true;
+        unindex(index);
+    }
+    return unlocked;
+}
+
+void AchievementEngine::unindex(std::size_t index) {
+    for (const AchievementCondition& condition : m_achievements[index].conditions) {
+        std::vector<std::size_t>& list = m_byCounter[static_cast<int>(condition.counter)];
+        list.erase(std::remove(list.begin(), list.end(), index), list.end());
+    }
+}
+
+std::vector<std::string> AchievementEngine::getIds() const {
+    std::vector<std::string> ids;
+    for (const Achievement& achievement : m_achievements) {
+        ids.push_back(achievement.id);
+    }
+    return ids;
+}
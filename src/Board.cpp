@@ -0,0 +1,161 @@
+#include "Board.hpp"
+#include <cstring>
+
+Board::Board() {
+    clear();
+}
+
+void Board::clear() {
+    std::memset(tableau, NO_CARD, sizeof(tableau));
+    std::memset(tableauSize, 0, sizeof(tableauSize));
+    std::memset(faceDown, 0, sizeof(faceDown));
+    std::memset(talon, NO_CARD, sizeof(talon));
+    talonSize = 0;
+    wasteSize = 0;
+    std::memset(foundation, NO_CARD, sizeof(foundation));
+    drawCount = 1;
+}
+
+int Board::pileSize(int pile) const {
+    if (pile == STOCK_PILE) {
+        return stockSize();
+    }
+    if (pile == WASTE_PILE) {
+        return wasteSize;
+    }
+    if (isFoundationPile(pile)) {
+        return foundationRank(pile - FOUNDATION_FIRST);
+    }
+    if (isTableauPile(pile)) {
+        return tableauSize[pile - TABLEAU_FIRST];
+    }
+    return 0;
+}
+
+int Board::foundationCardCount() const {
+    int count = 0;
+    for (int i = 0; i < FOUNDATION_COUNT; ++i) {
+        count += foundationRank(i);
+    }
+    return count;
+}
+
+bool Board::isWon() const {
+    return foundationCardCount() == CARD_COUNT;
+}
+
+bool Board::isValid() const {
+    if (talonSize > TALON_CAPACITY || wasteSize > talonSize) {
+        return false;
+    }
+    if (drawCount != 1 && drawCount != 3) {
+        return false;
+    }
+
+    bool seen[CARD_COUNT] = {};
+    int total = 0;
+
+    // Отмечаем карту и проверяем, что она встречается один раз
+    auto mark = [&seen, &total](CardId card) {
+        if (card >= CARD_COUNT || seen[card]) {
+            return false;
+        }
+        seen[card] = true;
+        ++total;
+        return true;
+    };
+
+    for (int column = 0; column < TABLEAU_COUNT; ++column) {
+        if (tableauSize[column] > TABLEAU_CAPACITY || faceDown[column] > tableauSize[column]) {
+            return false;
+        }
+        // Если в стопке есть карты, верхняя обязана быть открытой
+        if (tableauSize[column] > 0 && faceDown[column] == tableauSize[column]) {
+            return false;
+        }
+        for (int i = 0; i < tableauSize[column]; ++i) {
+            if (!mark(tableau[column][i])) {
+                return false;
+            }
+        }
+    }
+
+    for (int i = 0; i < talonSize; ++i) {
+        if (!mark(talon[i])) {
+            return false;
+        }
+    }
+
+    // База одной масти: все карты от туза до верхней
+    bool suitUsed[4] = {};
+    for (int i = 0; i < FOUNDATION_COUNT; ++i) {
+        CardId top = foundation[i];
+        if (top == NO_CARD) {
+            continue;
+        }
+        if (top >= CARD_COUNT || suitUsed[cardSuit(top)]) {
+            return false;
+        }
+        suitUsed[cardSuit(top)] = true;
+        for (int rank = 1; rank <= cardRank(top); ++rank) {
+            if (!mark(makeCardId(cardSuit(top), rank))) {
+                return false;
+            }
+        }
+    }
+
+    return total == CARD_COUNT;
+}
+
+bool Board::operator==(const Board& other) const {
+    if (talonSize != other.talonSize || wasteSize != other.wasteSize ||
+        drawCount != other.drawCount) {
+        return false;
+    }
+    if (std::memcmp(talon, other.talon, talonSize) != 0 ||
+        std::memcmp(foundation, other.foundation, sizeof(foundation)) != 0) {
+        return false;
+    }
+    for (int column = 0; column < TABLEAU_COUNT; ++column) {
+        if (tableauSize[column] != other.tableauSize[column] ||
+            faceDown[column] != other.faceDown[column] ||
+            std::memcmp(tableau[column], other.tableau[column], tableauSize[column]) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::string Board::cardName(CardId card) {
+    if (card >= CARD_COUNT) {
+        return "--";
+    }
+    static const char* ranks[] = {"A", "2", "3", "4", "5", "6", "7",
+                                  "8", "9", "10", "J", "Q", "K"};
+    static const char suits[] = {'H', 'D', 'C', 'S'};
+    return std::string(ranks[cardRank(card) - 1]) + suits[cardSuit(card)];
+}
+
+std::string Board::toString() const {
+    std::string result = "Stock:";
+    for (int i = talonSize - 1; i >= wasteSize; --i) {
+        result += " " + cardName(talon[i]);
+    }
+    result += "\nWaste:";
+    for (int i = 0; i < wasteSize; ++i) {
+        result += " " + cardName(talon[i]);
+    }
+    result += "\nFoundations:";
+    for (int i = 0; i < FOUNDATION_COUNT; ++i) {
+        result += " " + cardName(foundation[i]);
+    }
+    for (int column = 0; column < TABLEAU_COUNT; ++column) {
+        result += "\nTableau " + std::to_string(column + 1) + ":";
+        for (int i = 0; i < tableauSize[column]; ++i) {
+            result += i < faceDown[column] ? " [" + cardName(tableau[column][i]) + "]"
+                                           : " " + cardName(tableau[column][i]);
+        }
+    }
+    result += "\n";
+    return result;
+}
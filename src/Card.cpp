@@ -4,11 +4,15 @@
 #include "HintSystem.hpp"
 #include "SoundManager.hpp"
 #include "ScoreSystem.hpp"
+#include <algorithm>
 #include <iostream>
 
 // Инициализация статических переменных
 sf::Texture Card::s_cardTexture;
 sf::Texture Card::s_backTexture;
+sf::Texture Card::s_atlasTexture;
+bool Card::s_atlasReady = false;
+sf::Vector2i Card::s_atlasBackCell(0, 0);
 bool Card::s_debugMode = false;
 float Card::s_cardScale = 0.351111f; // Уменьшаем карты до 35% от оригинального размера
 
@@ -18,11 +22,17 @@ bool Card::loadTextures(const std::string& cardsPath, const std::string& backPat
         return false;
     }
 
-    if (!s_backTexture.loadFromFile(backPath)) {
+    sf::Image backImage;
+    if (!backImage.loadFromFile(backPath) || !s_backTexture.loadFromImage(backImage)) {
         std::cerr << "Failed to load card back texture from: " << backPath << std::endl;
         return false;
     }
 
+    // Без атласа карты просто рисуются по одной
+    if (!buildAtlas(cardsPath, backImage)) {
+        std::cerr << "Атлас карт не собран, пакетная отрисовка отключена" << std::endl;
+    }
+
     std::cout << "Текстуры карт успешно загружены: " << std::endl;
     std::cout << "- Карты: " << cardsPath << " (" << s_cardTexture.getSize().x << "x" << s_cardTexture.getSize().y << ")" << std::endl;
     std::cout << "- Рубашка: " << backPath << " (" << s_backTexture.getSize().x << "x" << s_backTexture.getSize().y << ")" << std::endl;
@@ -33,6 +43,65 @@ bool Card::loadTextures(const std::string& cardsPath, const std::string& backPat
     return true;
 }
 
+// Атлас: лист лиц как есть, под ним рубашка, приведённая к размеру карты.
+// Рубашка сжимается усреднением по области, а не на видеокарте при каждом кадре
+bool Card::buildAtlas(const std::string& cardsPath, const sf::Image& back) {
+    s_atlasReady = false;
+
+    sf::Image faces;
+    if (!faces.loadFromFile(cardsPath)) {
+        return false;
+    }
+    sf::Vector2u facesSize = faces.getSize();
+    sf::Vector2u backSize = back.getSize();
+    if (backSize.x == 0 || backSize.y == 0) {
+        return false;
+    }
+
+    sf::Image atlas;
+    atlas.create(std::max<unsigned>(facesSize.x, CARD_WIDTH), facesSize.y + CARD_HEIGHT, sf::Color::Transparent);
+    atlas.copy(faces, 0, 0);
+    s_atlasBackCell = sf::Vector2i(0, static_cast<int>(facesSize.y));
+
+    for (unsigned y = 0; y < static_cast<unsigned>(CARD_HEIGHT); ++y) {
+        unsigned y0 = y * backSize.y / CARD_HEIGHT;
+        unsigned y1 = std::max(y0 + 1, (y + 1) * backSize.y / CARD_HEIGHT);
+        for (unsigned x = 0; x < static_cast<unsigned>(CARD_WIDTH); ++x) {
+            unsigned x0 = x * backSize.x / CARD_WIDTH;
+            unsigned x1 = std::max(x0 + 1, (x + 1) * backSize.x / CARD_WIDTH);
+            unsigned sum[4] = {0, 0, 0, 0};
+            for (unsigned sy = y0; sy < y1; ++sy) {
+                for (unsigned sx = x0; sx < x1; ++sx) {
+                    sf::Color pixel = back.getPixel(sx, sy);
+                    sum[0] += pixel.r;
+                    sum[1] += pixel.g;
+                    sum[2] += pixel.b;
+                    sum[3] += pixel.a;
+                }
+            }
+            unsigned count = (x1 - x0) * (y1 - y0);
+            atlas.setPixel(x, facesSize.y + y,
+                           sf::Color(static_cast<sf::Uint8>(sum[0] / count), static_cast<sf::Uint8>(sum[1] / count),
+                                     static_cast<sf::Uint8>(sum[2] / count), static_cast<sf::Uint8>(sum[3] / count)));
+        }
+    }
+
+    // Слишком большой для видеокарты атлас не загрузится - это не ошибка игры
+    if (!s_atlasTexture.loadFromImage(atlas)) {
+        return false;
+    }
+    s_atlasReady = true;
+    return true;
+}
+
+const sf::Texture& Card::getAtlasTexture() {
+    return s_atlasTexture;
+}
+
+bool Card::hasAtlas() {
+    return s_atlasReady;
+}
+
 void Card::unloadTextures() {
     // SFML автоматически освобождает ресурсы при уничтожении текстур
 }
@@ -115,6 +184,35 @@ sf::IntRect Card::getCardTextureRect() const {
     );
 }
 
+sf::IntRect Card::getAtlasRect() const {
+    if (m_faceUp) {
+        return getCardTextureRect();
+    }
+    return sf::IntRect(s_atlasBackCell.x, s_atlasBackCell.y, CARD_WIDTH, CARD_HEIGHT);
+}
+
+void Card::appendVertices(sf::VertexArray& vertices) const {
+    const sf::Transform& transform = getTransform();
+    sf::IntRect rect = getAtlasRect();
+
+    // Та же геометрия, что у спрайтов: центр карты в точке привязки
+    const float halfWidth = CARD_WIDTH / 2.0f;
+    const float halfHeight = CARD_HEIGHT / 2.0f;
+    const sf::Vector2f corners[4] = {
+        transform.transformPoint(-halfWidth, -halfHeight), transform.transformPoint(halfWidth, -halfHeight),
+        transform.transformPoint(halfWidth, halfHeight), transform.transformPoint(-halfWidth, halfHeight)};
+    const float left = static_cast<float>(rect.left);
+    const float top = static_cast<float>(rect.top);
+    const float right = left + rect.width;
+    const float bottom = top + rect.height;
+    const sf::Vector2f texCoords[4] = {{left, top}, {right, top}, {right, bottom}, {left, bottom}};
+
+    static const int order[6] = {0, 1, 2, 0, 2, 3};
+    for (int index : order) {
+        vertices.append(sf::Vertex(corners[index], sf::Color::White, texCoords[index]));
+    }
+}
+
 Suit Card::getSuit() const {
     return m_suit;
 }
@@ -146,6 +244,12 @@ void Card::flip() {
     // Не меняем поворот и масштаб, так как они должны сохраняться
 }
 
+void Card::setFaceUp(bool faceUp) {
+    if (m_faceUp != faceUp) {
+        flip();
+    }
+}
+
 sf::FloatRect Card::getBounds() const {
     // Используем полный размер карты с учетом масштаба
     float scaledWidth = CARD_WIDTH * s_cardScale;
@@ -0,0 +1,84 @@
+#include "CardBatchRenderer.hpp"
+
+CardBatchRenderer::CardBatchRenderer()
+    : m_board(sf::Triangles), m_dragged(sf::Triangles), m_rebuildCount(0) {
+}
+
+CardBatchRenderer::CardState CardBatchRenderer::captureState(const Card& card) {
+    CardState state;
+    state.card = &card;
+    state.position = card.getPosition();
+    state.scale = card.getScale();
+    state.faceUp = card.isFaceUp();
+    return state;
+}
+
+bool CardBatchRenderer::isCurrent(const std::vector<std::shared_ptr<Pile>>& piles) const {
+    std::size_t index = 0;
+    for (const auto& pile : piles) {
+        for (const auto& card : pile->getCards()) {
+            if (index == m_states.size()) {
+                return false;
+            }
+            const CardState& state = m_states[index++];
+            if (state.card != card.get() || state.faceUp != card->isFaceUp() ||
+                state.position != card->getPosition() || state.scale != card->getScale()) {
+                return false;
+            }
+        }
+    }
+    return index == m_states.size();
+}
+
+void CardBatchRenderer::rebuild(const std::vector<std::shared_ptr<Pile>>& piles) {
+    // clear() оставляет память под вершины, пересборка ничего не выделяет
+    m_board.clear();
+    m_states.clear();
+    for (const auto& pile : piles) {
+        for (const auto& card : pile->getCards()) {
+            card->appendVertices(m_board);
+            m_states.push_back(captureState(*card));
+        }
+    }
+    ++m_rebuildCount;
+}
+
+bool CardBatchRenderer::refresh(const std::vector<std::shared_ptr<Pile>>& piles) {
+    if (isCurrent(piles)) {
+        return false;
+    }
+    rebuild(piles);
+    return true;
+}
+
+void CardBatchRenderer::drawBoard(sf::RenderTarget& target, const std::vector<std::shared_ptr<Pile>>& piles) {
+    refresh(piles);
+    if (!Card::hasAtlas() || Card::isDebugMode()) {
+        for (const auto& pile : piles) {
+            for (const auto& card : pile->getCards()) {
+                target.draw(*card);
+            }
+        }
+        return;
+    }
+
+    target.draw(m_board, sf::RenderStates(&Card::getAtlasTexture()));
+}
+
+void CardBatchRenderer::drawDragged(sf::RenderTarget& target, const std::vector<std::shared_ptr<Card>>& cards) {
+    if (cards.empty()) {
+        return;
+    }
+    if (!Card::hasAtlas() || Card::isDebugMode()) {
+        for (const auto& card : cards) {
+            target.draw(*card);
+        }
+        return;
+    }
+
+    m_dragged.clear();
+    for (const auto& card : cards) {
+        card->appendVertices(m_dragged);
+    }
+    target.draw(m_dragged, sf::RenderStates(&Card::getAtlasTexture()));
+}
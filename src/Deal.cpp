@@ -0,0 +1,36 @@
+#include "Deal.hpp"
+#include <random>
+
+void dealOrder(std::uint32_t dealNumber, CardId order[CARD_COUNT]) {
+    for (int i = 0; i < CARD_COUNT; ++i) {
+        order[i] = static_cast<CardId>(i);
+    }
+    shuffleDeal(order, CARD_COUNT, dealNumber);
+}
+
+Board dealBoard(std::uint32_t dealNumber, int drawCount) {
+    CardId order[CARD_COUNT];
+    dealOrder(dealNumber, order);
+
+    Board board;
+    board.drawCount = static_cast<std::uint8_t>(drawCount);
+    int next = 0;
+    for (int column = 0; column < Board::TABLEAU_COUNT; ++column) {
+        for (int i = 0; i <= column; ++i) {
+            board.tableau[column][i] = order[next++];
+        }
+        board.tableauSize[column] = static_cast<std::uint8_t>(column + 1);
+        board.faceDown[column] = static_cast<std::uint8_t>(column);
+    }
+
+    // Оставшиеся карты - колода
+    while (next < CARD_COUNT) {
+        board.talon[board.talonSize++] = order[next++];
+    }
+    return board;
+}
+
+std::uint32_t randomDealNumber() {
+    std::random_device rd;
+    return rd();
+}
@@ -0,0 +1,203 @@
+#include "DealDatabase.hpp"
+#include "BinaryIO.hpp"
+#include "Deal.hpp"
+#include <algorithm>
+#include <cstring>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static const char MAGIC[4] = {'K', 'D', 'D', 'B'};
+static const std::uint32_t VERSION = 1;
+static const std::size_t HEADER_SIZE = 32;
+static const std::size_t RECORD_SIZE = 2;
+
+const char* const DealDatabase::DEFAULT_PATH = "assets/deals.db";
+
+static std::uint16_t packRecord(SolveResult verdict, std::size_t length, std::uint8_t difficulty) {
+    std::size_t cappedLength = std::min<std::size_t>(length, DealDatabase::MAX_LENGTH);
+    return static_cast<std::uint16_t>(static_cast<unsigned>(verdict) | (difficulty << 2) | (cappedLength << 5));
+}
+
+DealDatabase& DealDatabase::getInstance() {
+    static DealDatabase instance;
+    static bool triedOpen = false;
+    if (!triedOpen) {
+        triedOpen = true;
+        instance.open(DEFAULT_PATH);
+    }
+    return instance;
+}
+
+DealDatabase::DealDatabase()
+    : m_mapping(nullptr), m_mappingSize(0), m_records(nullptr), m_drawCount(1), m_firstDeal(0),
+      m_dealCount(0), m_winnableCount(0) {
+}
+
+DealDatabase::~DealDatabase() {
+    close();
+}
+
+bool DealDatabase::open(const std::string& path) {
+    close();
+
+    // Отображаем файл целиком; страницы подгружаются по мере обращения
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart < static_cast<LONGLONG>(HEADER_SIZE)) {
+        CloseHandle(file);
+        return false;
+    }
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (!mapping) {
+        return false;
+    }
+    void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (!data) {
+        return false;
+    }
+    m_mappingSize = static_cast<std::size_t>(size.QuadPart);
+#else
+    int file = ::open(path.c_str(), O_RDONLY);
+    if (file < 0) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(file, &info) != 0 || info.st_size < static_cast<off_t>(HEADER_SIZE)) {
+        ::close(file);
+        return false;
+    }
+    void* data = mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_SHARED, file, 0);
+    ::close(file);
+    if (data == MAP_FAILED) {
+        return false;
+    }
+    m_mappingSize = static_cast<std::size_t>(info.st_size);
+#endif
+    m_mapping = data;
+
+    // Заголовок проверяем целиком: испорченный файл не должен давать пустую базу
+    // или номера раздач, вышедшие за пределы uint32
+    const unsigned char* header = static_cast<const unsigned char*>(m_mapping);
+    std::uint32_t firstDeal = readU32(header + 12);
+    std::uint32_t dealCount = readU32(header + 16);
+    std::uint32_t winnableCount = readU32(header + 20);
+    if (std::memcmp(header, MAGIC, 4) != 0 || readU32(header + 4) != VERSION || dealCount == 0 ||
+        winnableCount > dealCount || dealCount - 1 > 0xFFFFFFFFu - firstDeal ||
+        (m_mappingSize - HEADER_SIZE) / RECORD_SIZE < dealCount) {
+        close();
+        return false;
+    }
+
+    m_drawCount = static_cast<int>(readU32(header + 8));
+    m_firstDeal = firstDeal;
+    m_dealCount = dealCount;
+    m_winnableCount = winnableCount;
+    m_records = header + HEADER_SIZE;
+    return true;
+}
+
+void DealDatabase::close() {
+    if (m_mapping) {
+#ifdef _WIN32
+        UnmapViewOfFile(m_mapping);
+#else
+        munmap(m_mapping, m_mappingSize);
+#endif
+    }
+    m_mapping = nullptr;
+    m_mappingSize = 0;
+    m_records = nullptr;
+    m_dealCount = 0;
+    m_winnableCount = 0;
+}
+
+bool DealDatabase::lookup(std::uint32_t dealNumber, DealInfo& info) const {
+    if (!m_records || dealNumber < m_firstDeal || dealNumber - m_firstDeal >= m_dealCount) {
+        return false;
+    }
+    const unsigned char* record = m_records + static_cast<std::size_t>(dealNumber - m_firstDeal) * RECORD_SIZE;
+    std::uint16_t value = readU16(record);
+    info.verdict = static_cast<SolveResult>(std::min(value & 3, 2));
+    info.difficulty = static_cast<std::uint8_t>((value >> 2) & 7);
+    info.length = static_cast<std::uint16_t>(value >> 5);
+    return true;
+}
+
+bool DealDatabase::pickWinnable(std::uint64_t entropy, std::uint32_t& dealNumber) const {
+    if (!m_records || m_dealCount == 0 || m_winnableCount == 0) {
+        return false;
+    }
+
+    // Обычно выигрышных большинство, и хватает нескольких попыток
+    DealRandom random(entropy);
+    DealInfo info;
+    for (int attempt = 0; attempt < 64; ++attempt) {
+        std::uint32_t candidate = m_firstDeal + random.below(m_dealCount);
+        if (lookup(candidate, info) && info.verdict == SolveResult::WINNABLE) {
+            dealNumber = candidate;
+            return true;
+        }
+    }
+
+    // Выигрышных мало - ищем подряд от случайного места
+    std::uint32_t start = random.below(m_dealCount);
+    for (std::uint32_t i = 0; i < m_dealCount; ++i) {
+        std::uint32_t candidate = m_firstDeal + (start + i) % m_dealCount;
+        if (lookup(candidate, info) && info.verdict == SolveResult::WINNABLE) {
+            dealNumber = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+DealDatabaseBuilder::DealDatabaseBuilder(std::uint32_t firstDeal, int drawCount)
+    : m_firstDeal(firstDeal), m_drawCount(drawCount), m_winnableCount(0) {
+}
+
+std::uint8_t DealDatabaseBuilder::difficultyFor(std::uint64_t nodes) {
+    std::uint8_t difficulty = 0;
+    for (std::uint64_t limit = 1024; nodes >= limit && difficulty < 7; limit *= 4) {
+        ++difficulty;
+    }
+    return difficulty;
+}
+
+void DealDatabaseBuilder::add(SolveResult verdict, std::size_t length, std::uint64_t nodes) {
+    if (verdict == SolveResult::WINNABLE) {
+        ++m_winnableCount;
+    }
+    m_records.push_back(packRecord(verdict, length, difficultyFor(nodes)));
+}
+
+bool DealDatabaseBuilder::write(const std::string& path) const {
+    // База целиком в памяти и подменяет прежнюю одной записью
+    std::vector<unsigned char> bytes(HEADER_SIZE + m_records.size() * RECORD_SIZE, 0);
+    unsigned char* header = bytes.data();
+    std::memcpy(header, MAGIC, 4);
+    writeU32(header + 4, VERSION);
+    writeU32(header + 8, static_cast<std::uint32_t>(m_drawCount));
+    writeU32(header + 12, m_firstDeal);
+    writeU32(header + 16, getDealCount());
+    writeU32(header + 20, m_winnableCount);
+    for (std::size_t i = 0; i < m_records.size(); ++i) {
+        writeU16(header + HEADER_SIZE + i * RECORD_SIZE, m_records[i]);
+    }
+    return writeFileAtomic(path, bytes);
+}
@@ -1,6 +1,7 @@
 #include "Deck.hpp"
+#include "Deal.hpp"
 #include <algorithm>
-#include <random>
+#include <cassert>
 
 Deck::Deck() {
     // Создаем 52 карты
@@ -11,10 +12,39 @@ Deck::Deck() {
     }
 }
 
+static CardId toCardId(const Card& card) {
+    return makeCardId(static_cast<int>(card.getSuit()), static_cast<int>(card.getRank()));
+}
+
+#ifndef NDEBUG
+// Проверка: колода выдаёт карты (с конца) в порядке dealOrder(dealNumber)
+static bool matchesDealOrder(const std::vector<std::shared_ptr<Card>>& cards, std::uint32_t dealNumber) {
+    CardId order[CARD_COUNT];
+    dealOrder(dealNumber, order);
+    for (int i = 0; i < CARD_COUNT; ++i) {
+        if (toCardId(*cards[CARD_COUNT - 1 - i]) != order[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+#endif
+
 void Deck::shuffle() {
-    std::random_device rd;
-    std::mt19937 g(rd());
-    std::shuffle(m_cards.begin(), m_cards.end(), g);
+    shuffle(randomDealNumber());
+}
+
+void Deck::shuffle(std::uint32_t dealNumber) {
+    // shuffleDeal тасует колоду, упорядоченную как CardId, и даёт порядок выдачи
+    // с начала; карты выдаются с конца, поэтому после тасовки переворачиваем:
+    // полная колода после shuffle(n) выдаёт карты в порядке dealOrder(n)
+    std::sort(m_cards.begin(), m_cards.end(),
+              [](const std::shared_ptr<Card>& a, const std::shared_ptr<Card>& b) {
+                  return toCardId(*a) < toCardId(*b);
+              });
+    shuffleDeal(m_cards.data(), static_cast<int>(m_cards.size()), dealNumber);
+    std::reverse(m_cards.begin(), m_cards.end());
+    assert(m_cards.size() != static_cast<size_t>(CARD_COUNT) || matchesDealOrder(m_cards, dealNumber));
 }
 
 std::shared_ptr<Card> Deck::drawCard() {
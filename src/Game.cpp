@@ -1,117 +1,20 @@
 #include "Game.hpp"
 #include "AnimationManager.hpp"
 #include "Card.hpp"
+#include "Deal.hpp"
+#include "DealDatabase.hpp"
+#include "GameHistory.hpp"
 #include "GameTimer.hpp"
 #include "HintSystem.hpp"
+#include "Leaderboard.hpp"
+#include "MoveGenerator.hpp"
 #include "PopupImage.hpp"
 #include "ScoreSystem.hpp"
 #include "SoundManager.hpp"
 #include "StatsManager.hpp"
 #include <algorithm>
+#include <ctime>
 #include <iostream>
-#include <random>
-
-// Реализация MoveCardCommand
-MoveCardCommand::MoveCardCommand(Game *game, std::shared_ptr<Card> card,
-                                 std::shared_ptr<Pile> sourcePile,
-                                 std::shared_ptr<Pile> targetPile)
-    : m_game(game), m_card(card), m_sourcePile(sourcePile),
-      m_targetPile(targetPile), m_flippedCardInSourcePile(false) {}
-
-void MoveCardCommand::execute() {
-  if (m_targetPile->canAddCard(m_card)) {
-    m_sourcePile->removeTopCard();
-    m_targetPile->addCard(m_card);
-
-    // Проверяем, нужно ли перевернуть карту в исходной стопке
-    if (m_sourcePile->getType() == PileType::TABLEAU &&
-        !m_sourcePile->isEmpty()) {
-      auto topCard = m_sourcePile->getTopCard();
-      if (topCard && !topCard->isFaceUp()) {
-        topCard->flip();
-        m_flippedCardInSourcePile = true;
-      }
-    }
-  }
-}
-
-void MoveCardCommand::undo() {
-  // Запоминаем, была ли карта перевернута в исходной стопке
-  bool needToFlipCardInSourcePile = m_flippedCardInSourcePile;
-
-  // Удаляем карту из целевой стопки
-  if (!m_targetPile->isEmpty()) {
-    m_targetPile->removeTopCard();
-  }
-
-  // Если карта перемещалась из STOCK в WASTE, переворачиваем её обратно
-  if (m_sourcePile->getType() == PileType::STOCK &&
-      m_targetPile->getType() == PileType::WASTE) {
-    if (m_card->isFaceUp()) {
-      m_card->flip();
-    }
-  }
-
-  // Добавляем карту обратно в исходную стопку
-  m_sourcePile->addCard(m_card);
-
-  // Если в исходной стопке была перевернута карта, переворачиваем её обратно
-  if (needToFlipCardInSourcePile && !m_sourcePile->isEmpty()) {
-    // Теперь эта карта должна быть предпоследней в стопке
-    if (m_sourcePile->getCardCount() >= 2) {
-      auto cardToFlip =
-          m_sourcePile->getCardAt(m_sourcePile->getCardCount() - 2);
-      if (cardToFlip && cardToFlip->isFaceUp()) {
-        cardToFlip->flip(); // Переворачиваем обратно рубашкой вверх
-      }
-    }
-  }
-}
-
-// Реализация MoveCardsCommand
-MoveCardsCommand::MoveCardsCommand(
-    Game *game, const std::vector<std::shared_ptr<Card>> &cards,
-    std::shared_ptr<Pile> sourcePile, std::shared_ptr<Pile> targetPile,
-    bool flippedCardInSourcePile)
-    : m_game(game), m_cards(cards), m_sourcePile(sourcePile),
-      m_targetPile(targetPile),
-      m_flippedCardInSourcePile(flippedCardInSourcePile) {}
-
-void MoveCardsCommand::execute() {
-  // Карты уже удалены из исходной стопки в handleMousePressed()
-  // и добавлены в целевую в handleMouseReleased(),
-  // поэтому здесь не нужно перемещать карты снова
-}
-
-void MoveCardsCommand::undo() {
-  // Запоминаем, была ли карта перевернута в исходной стопке
-  bool needToFlipCardInSourcePile = m_flippedCardInSourcePile;
-
-  // Удаляем карты из целевой стопки в обратном порядке
-  for (size_t i = 0; i < m_cards.size(); ++i) {
-    if (!m_targetPile->isEmpty()) {
-      m_targetPile->removeTopCard();
-    }
-  }
-
-  // Добавляем карты обратно в исходную стопку
-  for (const auto &card : m_cards) {
-    m_sourcePile->addCard(card);
-  }
-
-  // Если в исходной стопке была перевернута карта, переворачиваем её обратно
-  if (needToFlipCardInSourcePile && !m_sourcePile->isEmpty()) {
-    // Эта карта теперь должна быть предпоследней в стопке (перед добавленными
-    // картами)
-    size_t indexToFlip = m_sourcePile->getCardCount() - m_cards.size() - 1;
-    if (indexToFlip < m_sourcePile->getCardCount()) {
-      auto cardToFlip = m_sourcePile->getCardAt(indexToFlip);
-      if (cardToFlip && cardToFlip->isFaceUp()) {
-        cardToFlip->flip(); // Переворачиваем обратно рубашкой вверх
-      }
-    }
-  }
-}
 
 Game::Game()
     : m_dragSourcePile(nullptr), m_lastClickedCard(nullptr),
@@ -124,19 +27,45 @@ Game::Game()
                             "assets/popups/invalid_move.png");
 }
 
-Game::~Game() {
-  // Очищаем стек отмены
-  while (!m_undoStack.empty()) {
-    m_undoStack.pop();
+Game::~Game() {}
+
+// Номер новой раздачи: выигрышная из базы раздач, если она есть
+static std::uint32_t chooseDealNumber() {
+  const DealDatabase &database = DealDatabase::getInstance();
+  std::uint64_t entropy =
+      (static_cast<std::uint64_t>(randomDealNumber()) << 32) | randomDealNumber();
+  std::uint32_t dealNumber = 0;
+  if (database.getDrawCount() == 1 &&
+      database.pickWinnable(entropy, dealNumber)) {
+    return dealNumber;
   }
+  return randomDealNumber();
+}
+
+void Game::initialize() { initialize(chooseDealNumber()); }
+
+void Game::initialize(std::uint32_t dealNumber) {
+  m_journal.recordNewGame(dealNumber);
+  StatsManager::getInstance().gameStarted();
+  m_undoCount = 0;
+  m_hintCount = 0;
+
+  setupDeal(dealNumber);
+  startReplay();
 }
 
-void Game::initialize() {
-  // Создаем стопки
-  createPiles();
+void Game::setupDeal(std::uint32_t dealNumber) {
+  m_dealNumber = dealNumber;
+  m_resultRecorded = false;
+
+  // Стопки и карты создаются один раз, новая игра переиспользует их
+  if (m_piles.empty()) {
+    createPiles();
+    createCards();
+  }
 
-  // Создаем карты
-  createCards();
+  // Собираем колоду
+  shuffleCards();
 
   // Раздаем карты
   dealCards();
@@ -152,11 +81,14 @@ void Game::initialize() {
   clearHint();
 }
 
-void Game::createPiles() {
-  m_piles.clear();
-  m_foundationPiles.clear();
-  m_tableauPiles.clear();
+void Game::startReplay() {
+  if (!m_replay.start(ReplayRecorder::DEFAULT_PATH, m_dealNumber,
+                      captureBoard())) {
+    std::cerr << "Не удалось начать запись партии" << std::endl;
+  }
+}
 
+void Game::createPiles() {
   // Создаем стопку колоды (stock)
   m_stockPile =
       std::make_shared<Pile>(PileType::STOCK, sf::Vector2f(50.0f, 50.0f));
@@ -185,26 +117,32 @@ void Game::createPiles() {
 }
 
 void Game::createCards() {
-  // Создаем 52 карты
+  // Пул из 52 карт в порядке CardId; спрайты настраиваются только здесь
+  m_cardPool.reserve(CARD_COUNT);
   for (int suit = 0; suit < 4; ++suit) {
     for (int rank = 1; rank <= 13; ++rank) {
-      auto card = std::make_shared<Card>(static_cast<Suit>(suit),
-                                         static_cast<Rank>(rank));
-      m_stockPile->addCard(card);
+      m_cardPool.push_back(std::make_shared<Card>(static_cast<Suit>(suit),
+                                                  static_cast<Rank>(rank)));
     }
   }
+}
 
-  // Перемешиваем карты
-  std::vector<std::shared_ptr<Card>> cards;
-  while (!m_stockPile->isEmpty()) {
-    cards.push_back(m_stockPile->removeTopCard());
+void Game::shuffleCards() {
+  // Убираем карты из стопок; ёмкость векторов стопок сохраняется
+  m_draggedCards.clear();
+  m_dragSourcePile = nullptr;
+  for (const auto &pile : m_piles) {
+    pile->clear();
   }
-
-  std::random_device rd;
-  std::mt19937 g(rd());
-  std::shuffle(cards.begin(), cards.end(), g);
-
-  for (const auto &card : cards) {
+  m_hintCacheValid = false;
+
+  // Перемешиваем по номеру раздачи; первая сдаваемая карта - сверху колоды
+  CardId order[CARD_COUNT];
+  dealOrder(m_dealNumber, order);
+  for (int i = CARD_COUNT - 1; i >= 0; --i) {
+    const auto &card = m_cardPool[order[i]];
+    card->setDragging(false);
+    card->setFaceUp(false);
     m_stockPile->addCard(card);
   }
 
@@ -229,6 +167,211 @@ void Game::dealCards() {
   }
 }
 
+// Идентификатор карты в компактном представлении позиции
+static CardId toCardId(const Card &card) {
+  return makeCardId(static_cast<int>(card.getSuit()),
+                    static_cast<int>(card.getRank()));
+}
+
+int Game::getPileIndex(const Pile *pile) const {
+  for (size_t i = 0; i < m_piles.size(); ++i) {
+    if (m_piles[i].get() == pile) {
+      return static_cast<int>(i);
+    }
+  }
+  return -1;
+}
+
+// Кладёт карту в позицию; карты стопки перечисляются снизу вверх
+static void placeCard(Board &board, int pile, const Card &card) {
+  if (pile == WASTE_PILE) {
+    if (board.talonSize < Board::TALON_CAPACITY) {
+      board.talon[board.talonSize++] = toCardId(card);
+      board.wasteSize = board.talonSize;
+    }
+  } else if (isFoundationPile(pile)) {
+    board.foundation[pile - FOUNDATION_FIRST] = toCardId(card);
+  } else if (isTableauPile(pile)) {
+    int column = pile - TABLEAU_FIRST;
+    if (board.tableauSize[column] < Board::TABLEAU_CAPACITY) {
+      if (!card.isFaceUp() && board.faceDown[column] == board.tableauSize[column]) {
+        board.faceDown[column]++;
+      }
+      board.tableau[column][board.tableauSize[column]++] = toCardId(card);
+    }
+  }
+}
+
+void Game::readPile(Board &board, int index) const {
+  const auto &pile = m_piles[index];
+
+  // Сброс и колода - один массив talon, читаются вместе
+  if (index == STOCK_PILE || index == WASTE_PILE) {
+    std::fill(board.talon, board.talon + Board::TALON_CAPACITY, NO_CARD);
+    board.talonSize = 0;
+    board.wasteSize = 0;
+    readCards(board, WASTE_PILE, *m_wastePile);
+
+    // Колода идёт в talon в порядке выдачи: верхняя карта стопки - первой
+    const auto &stock = m_stockPile->getCards();
+    for (auto it = stock.rbegin(); it != stock.rend(); ++it) {
+      if (board.talonSize < Board::TALON_CAPACITY) {
+        board.talon[board.talonSize++] = toCardId(**it);
+      }
+    }
+    return;
+  }
+
+  if (isFoundationPile(index)) {
+    board.foundation[index - FOUNDATION_FIRST] = NO_CARD;
+  } else {
+    int column = index - TABLEAU_FIRST;
+    std::fill(board.tableau[column], board.tableau[column] + Board::TABLEAU_CAPACITY, NO_CARD);
+    board.tableauSize[column] = 0;
+    board.faceDown[column] = 0;
+  }
+  readCards(board, index, *pile);
+}
+
+void Game::readCards(Board &board, int index, const Pile &pile) const {
+  // Карты берём по ссылке, чтобы не трогать счётчики shared_ptr
+  for (const auto &card : pile.getCards()) {
+    placeCard(board, index, *card);
+  }
+  // Перетаскиваемые карты считаются лежащими в исходной стопке
+  if (m_dragSourcePile.get() == &pile) {
+    for (const auto &card : m_draggedCards) {
+      placeCard(board, index, *card);
+    }
+  }
+}
+
+Board Game::captureBoard() const {
+  Board board;
+  for (int index = WASTE_PILE; index < static_cast<int>(m_piles.size()); ++index) {
+    readPile(board, index);
+  }
+  return board;
+}
+
+const HintCache &Game::getHintCache() const {
+  if (!m_hintCacheValid) {
+    m_hintCache.reset(captureBoard());
+    m_hintCacheValid = true;
+  } else {
+    // Перечитываем только стопки, изменившиеся с прошлого раза
+    std::uint32_t dirtyMask = 0;
+    for (int index = 0; index < PILE_COUNT; ++index) {
+      if (m_piles[index]->getVersion() != m_pileVersions[index]) {
+        dirtyMask |= 1u << index;
+      }
+    }
+    // Перетаскиваемые карты считаются лежащими в исходной стопке, поэтому
+    // начало и конец перетаскивания тоже меняют позицию
+    if (m_dragSourcePile.get() != m_cachedDragSource ||
+        m_draggedCards.size() != m_cachedDragCount) {
+      int oldSource = getPileIndex(m_cachedDragSource);
+      int newSource = getPileIndex(m_dragSourcePile.get());
+      if (oldSource >= 0) {
+        dirtyMask |= 1u << oldSource;
+      }
+      if (newSource >= 0) {
+        dirtyMask |= 1u << newSource;
+      }
+    }
+    if (dirtyMask == 0) {
+      return m_hintCache;
+    }
+
+    Board board = m_hintCache.getBoard();
+    for (int index = WASTE_PILE; index < PILE_COUNT; ++index) {
+      if (((dirtyMask >> index) & 1) ||
+          (index == WASTE_PILE && (dirtyMask & (1u << STOCK_PILE)))) {
+        readPile(board, index);
+      }
+    }
+    m_hintCache.update(board, dirtyMask);
+  }
+
+  for (int index = 0; index < PILE_COUNT; ++index) {
+    m_pileVersions[index] = m_piles[index]->getVersion();
+  }
+  m_cachedDragSource = m_dragSourcePile.get();
+  m_cachedDragCount = m_draggedCards.size();
+  return m_hintCache;
+}
+
+std::shared_ptr<Pile> Game::findAutoMoveTarget(const Pile *sourcePile,
+                                               size_t cardIndex) const {
+  int source = getPileIndex(sourcePile);
+  if (source < 0 || cardIndex >= sourcePile->getCardCount()) {
+    return nullptr;
+  }
+  int count = static_cast<int>(sourcePile->getCardCount() - cardIndex);
+
+  // Ходы в базы идут раньше ходов в игровые стопки
+  for (const Move &move : getHintCache().getMoves()) {
+    if (move.from == source && move.count == count && !move.isDraw() &&
+        !move.isRecycle()) {
+      return m_piles[move.to];
+    }
+  }
+  return nullptr;
+}
+
+bool Game::applyBoard(const Board &board) {
+  if (!board.isValid() || m_piles.size() != static_cast<size_t>(PILE_COUNT)) {
+    return false;
+  }
+
+  // Прерываем перетаскивание и очищаем состояние, связанное со старой позицией
+  for (const auto &card : m_draggedCards) {
+    card->setDragging(false);
+  }
+  m_draggedCards.clear();
+  m_dragSourcePile = nullptr;
+  m_lastClickedCard = nullptr;
+  clearHint();
+  m_history.clear();
+
+  for (const auto &pile : m_piles) {
+    pile->clear();
+  }
+
+  // Кладём карту из пула в стопку в нужном положении
+  auto place = [this](const std::shared_ptr<Pile> &pile, CardId id,
+                      bool faceUp) {
+    const auto &card = m_cardPool[id];
+    card->setFaceUp(faceUp);
+    pile->addCard(card);
+  };
+
+  for (int i = board.talonSize - 1; i >= board.wasteSize; --i) {
+    place(m_stockPile, board.talon[i], false);
+  }
+  for (int i = 0; i < board.wasteSize; ++i) {
+    place(m_wastePile, board.talon[i], true);
+  }
+  for (int i = 0; i < Board::FOUNDATION_COUNT; ++i) {
+    CardId top = board.foundation[i];
+    if (top == NO_CARD) {
+      continue;
+    }
+    for (int rank = 1; rank <= cardRank(top); ++rank) {
+      place(m_foundationPiles[i], makeCardId(cardSuit(top), rank), true);
+    }
+  }
+  for (int column = 0; column < Board::TABLEAU_COUNT; ++column) {
+    for (int i = 0; i < board.tableauSize[column]; ++i) {
+      place(m_tableauPiles[column], board.tableau[column][i],
+            i >= board.faceDown[column]);
+    }
+  }
+
+  startReplay();
+  return true;
+}
+
 void Game::handleMouseMoved(const sf::Vector2f &position) {
   // Обновляем позиции перетаскиваемых карт
   if (!m_draggedCards.empty()) {
@@ -242,7 +385,14 @@ void Game::handleMouseMoved(const sf::Vector2f &position) {
 
 void Game::update(sf::Time deltaTime) {
   try {
-      // Обновляем все стопки
+      // Ходы кадра уходят в журнал вместе с текущими временем и счётом
+      m_journal.commit(m_timer ? m_timer->getElapsedSeconds() : 0,
+                       m_scoreSystem ? m_scoreSystem->getScore() : 0);
+      if (m_journal.wantsSnapshot()) {
+          m_journal.snapshot(makeSaveData());
+      }
+
+      // Расставляем карты, сдвинутые изменениями стопок; нетронутые стопки пропускаются сразу
       for (const auto &pile : m_piles) {
           pile->update();
       }
@@ -295,12 +445,29 @@ void Game::clearHint() {
 }
 
 void Game::draw(sf::RenderWindow &window) {
+  drawTable(window);
+  drawOverlay(window);
+}
+
+unsigned Game::refreshTable() {
+  m_cardRenderer.refresh(m_piles);
+  return m_cardRenderer.getRebuildCount();
+}
+
+void Game::drawTable(sf::RenderTarget &target) {
   try {
-    // Рисуем все стопки
+    // Рамки стопок, затем все карты стола одним массивом вершин
     for (const auto &pile : m_piles) {
-      window.draw(*pile);
+      pile->drawFrame(target);
     }
+    m_cardRenderer.drawBoard(target, m_piles);
+  } catch (const std::exception& e) {
+    std::cerr << "Ошибка при отрисовке стола: " << e.what() << std::endl;
+  }
+}
 
+void Game::drawOverlay(sf::RenderTarget &target) {
+  try {
     // Отрисовка подсказки, если она активна
     if (m_showingHint) {
         float pulse = (std::sin(m_hintPulseLevel) + 1.0f) * 0.5f; // 0.0-1.0
@@ -323,7 +490,7 @@ void Game::draw(sf::RenderWindow &window) {
             highlight.setOrigin(47, 64); // Небольшое смещение для центрирования
             highlight.setPosition(cardPos);
             highlight.setFillColor(sf::Color(255, 255, 0, static_cast<sf::Uint8>(80 * pulse)));
-            window.draw(highlight);
+            target.draw(highlight);
         }
 
         // Подсветка целевой стопки
@@ -353,7 +520,7 @@ void Game::draw(sf::RenderWindow &window) {
           targetHighlight.setFillColor(sf::Color(0, 255, 0, static_cast<sf::Uint8>(80 * pulse)));
           targetHighlight.setOutlineThickness(2.0f);
           targetHighlight.setOutlineColor(sf::Color(0, 180, 0, static_cast<sf::Uint8>(150 * pulse)));
-          window.draw(targetHighlight);
+          target.draw(targetHighlight);
 
           // Добавим стрелку или линию, соединяющую исходную карту с целевой позицией
           if (!m_hintCards.empty()) {
@@ -365,7 +532,7 @@ void Game::draw(sf::RenderWindow &window) {
                   sf::Vertex(highlightPos, sf::Color(0, 255, 0, static_cast<sf::Uint8>(150 * pulse)))
               };
 
-              window.draw(line, 2, sf::Lines);
+              target.draw(line, 2, sf::Lines);
           }
       }
 
@@ -378,18 +545,16 @@ void Game::draw(sf::RenderWindow &window) {
             pileHighlight.setOrigin(8, 2);
             pileHighlight.setPosition(pilePos);
             pileHighlight.setFillColor(sf::Color(0, 255, 255, static_cast<sf::Uint8>(80 * pulse)));
-            window.draw(pileHighlight);
+            target.draw(pileHighlight);
         }
     }
 
     // Рисуем перетаскиваемые карты поверх всех стопок
-    for (const auto &card : m_draggedCards) {
-      window.draw(*card);
-    }
+    m_cardRenderer.drawDragged(target, m_draggedCards);
 
     // Рисуем всплывающее изображение, если оно видимо
     if (m_popupImage.isVisible()) {
-      window.draw(m_popupImage);
+      target.draw(m_popupImage);
     }
   } catch (const std::exception& e) {
     std::cerr << "Ошибка при отрисовке игры: " << e.what() << std::endl;
@@ -419,13 +584,8 @@ bool Game::tryAutoMoveAceToFoundation(std::shared_ptr<Card> card,
   if (shouldAutoMoveAceToFoundation(card)) {
     auto foundation = findFoundationForAce();
     if (foundation) {
-      // Создаем команду для перемещения
-      auto command =
-          std::make_unique<MoveCardCommand>(this, card, sourcePile, foundation);
-      command->execute();
-
-      // Добавляем команду в стек отмены
-      m_undoStack.push(std::move(command));
+      Move move = pileMove(sourcePile.get(), foundation.get(), 1);
+      executeMove(move);
 
       // Проигрываем звук размещения
       try {
@@ -457,12 +617,14 @@ void Game::handleMousePressed(const sf::Vector2f &position) {
     // Ищем карту под курсором
     std::shared_ptr<Card> clickedCard = nullptr;
     std::shared_ptr<Pile> cardPile = nullptr;
+    size_t clickedIndex = 0;
 
     for (const auto &pile : m_piles) {
       size_t cardIndex = pile->getCardIndex(position);
       if (cardIndex < pile->getCardCount()) {
         clickedCard = pile->getCardAt(cardIndex);
         cardPile = pile;
+        clickedIndex = cardIndex;
         break;
       }
     }
@@ -477,115 +639,43 @@ void Game::handleMousePressed(const sf::Vector2f &position) {
 
         bool moved = false;
 
-        // 1. Сначала пробуем перемещение в фундамент (более приоритетно)
-        for (auto &foundation : m_foundationPiles) {
-          if (foundation->canAddCard(clickedCard)) {
-            // Запоминаем, были ли карты под текущей картой в исходной стопке
-            // и находим следующую карту для потенциального переворота
-            std::shared_ptr<Card> nextCard = nullptr;
-            bool hasCardBelowCurrent = (cardPile->getCardCount() > 1);
-
-            if (hasCardBelowCurrent && cardPile->getType() == PileType::TABLEAU) {
-              // Получаем вторую сверху карту, которая будет верхней после удаления
-              nextCard = cardPile->getCardAt(cardPile->getCardCount() - 2);
-            }
-
-            // Запоминаем, была ли вторая сверху карта закрытой
-            bool nextCardWasFaceDown = (nextCard && !nextCard->isFaceUp());
-
-            // Удаляем карту из исходной стопки
-            cardPile->removeTopCard();
-
-            // Добавляем в целевую стопку
-            foundation->addCard(clickedCard);
-
-            // Переворачиваем следующую карту, если нужно
-            if (nextCardWasFaceDown && nextCard) {
-              nextCard->flip();
-            }
-
-            // Звуковые эффекты и очки
-            SoundManager::getInstance().playSound(SoundEffect::CARD_PLACE);
-            if (m_scoreSystem) {
-              m_scoreSystem->calculateMoveScore(clickedCard, cardPile, foundation);
-            }
-            StatsManager::getInstance().incrementMoves();
-
-            // Создаем команду для отмены с правильной информацией о перевороте карты
-            auto command = std::make_unique<MoveCardCommand>(
-                this, clickedCard, cardPile, foundation);
-
-            // Выполняем команду, что установит флаг переворота правильно
-            // (или просто добавляем в стек, так как перемещение уже выполнено)
-            m_undoStack.push(std::move(command));
-
-            std::cout << "Автоматически перемещено в фундамент" << std::endl;
-            moved = true;
-            break;
+        // Цель подбирает генератор ходов: сначала фундамент, затем tableau
+        std::shared_ptr<Pile> target = findAutoMoveTarget(cardPile.get(), clickedIndex);
+
+        // 1. Перемещение в фундамент (только верхняя карта)
+        if (target && target->getType() == PileType::FOUNDATION) {
+          auto foundation = target;
+
+          Move move = pileMove(cardPile.get(), foundation.get(), 1);
+          executeMove(move);
+
+          // Звуковые эффекты и очки
+          SoundManager::getInstance().playSound(SoundEffect::CARD_PLACE);
+          if (m_scoreSystem) {
+            m_scoreSystem->calculateMoveScore(clickedCard, cardPile, foundation);
           }
-        }
+          StatsManager::getInstance().incrementMoves();
 
-        // 2. Если не переместили в фундамент, пробуем в tableau
-        if (!moved) {
-          for (auto &tableau : m_tableauPiles) {
-            if (tableau != cardPile && tableau->canAddCard(clickedCard)) {
-              // Находим индекс кликнутой карты в стопке
-              size_t cardIndex = 0;
-              for (size_t i = 0; i < cardPile->getCardCount(); i++) {
-                if (cardPile->getCardAt(i) == clickedCard) {
-                  cardIndex = i;
-                  break;
-                }
-              }
-
-              // Проверяем, можно ли удалить карту и все карты над ней
-              if (cardPile->canRemoveCards(cardIndex)) {
-                // Проверяем, есть ли следующая карта, которую нужно будет перевернуть
-                bool hasNextCard = (cardIndex > 0);
-                bool nextCardWasFaceDown = false;
-
-                if (hasNextCard && cardPile->getType() == PileType::TABLEAU) {
-                  auto nextCard = cardPile->getCardAt(cardIndex - 1);
-                  nextCardWasFaceDown = !nextCard->isFaceUp();
-                }
-
-                // Удаляем карту и все карты над ней
-                std::vector<std::shared_ptr<Card>> cardsToMove =
-                    cardPile->removeCards(cardIndex);
-
-                // Добавляем все карты в целевую стопку
-                for (auto &card : cardsToMove) {
-                  tableau->addCard(card);
-                }
-
-                // Переворачиваем следующую карту, если нужно
-                if (nextCardWasFaceDown && cardPile->getType() == PileType::TABLEAU &&
-                    !cardPile->isEmpty()) {
-                  auto topCard = cardPile->getTopCard();
-                  if (!topCard->isFaceUp()) {
-                    topCard->flip();
-                  }
-                }
-
-                // Звуковые эффекты и очки
-                SoundManager::getInstance().playSound(SoundEffect::CARD_PLACE);
-                if (m_scoreSystem) {
-                  m_scoreSystem->calculateMoveScore(clickedCard, cardPile, tableau);
-                }
-                StatsManager::getInstance().incrementMoves();
-
-                // Сохраняем для отмены с правильным флагом переворота
-                auto command = std::make_unique<MoveCardsCommand>(
-                    this, cardsToMove, cardPile, tableau, nextCardWasFaceDown);
-                m_undoStack.push(std::move(command));
-
-                std::cout << "Автоматически перемещена группа карт в tableau"
-                          << std::endl;
-                moved = true;
-                break;
-              }
-            }
+          std::cout << "Автоматически перемещено в фундамент" << std::endl;
+          moved = true;
+        }
+        // 2. Перемещение карты и всех карт над ней в tableau
+        else if (target) {
+          auto tableau = target;
+          Move move = pileMove(cardPile.get(), tableau.get(),
+                               cardPile->getCardCount() - clickedIndex);
+          executeMove(move);
+
+          // Звуковые эффекты и очки
+          SoundManager::getInstance().playSound(SoundEffect::CARD_PLACE);
+          if (m_scoreSystem) {
+            m_scoreSystem->calculateMoveScore(clickedCard, cardPile, tableau);
           }
+          StatsManager::getInstance().incrementMoves();
+
+          std::cout << "Автоматически перемещена группа карт в tableau"
+                    << std::endl;
+          moved = true;
         }
 
         if (!moved) {
@@ -614,10 +704,10 @@ void Game::handleMousePressed(const sf::Vector2f &position) {
     if (m_stockPile->contains(position)) {
       if (m_stockPile->isEmpty()) {
         // Если колода пуста, перекладываем карты из сброса обратно в колоду
-        while (!m_wastePile->isEmpty()) {
-          auto card = m_wastePile->removeTopCard();
-          card->flip(); // Переворачиваем карту обратно рубашкой вверх
-          m_stockPile->addCard(card);
+        if (!m_wastePile->isEmpty()) {
+          Move move = pileMove(m_wastePile.get(), m_stockPile.get(),
+                               m_wastePile->getCardCount());
+          executeMove(move);
         }
 
         // Проигрываем звук перемешивания
@@ -628,14 +718,9 @@ void Game::handleMousePressed(const sf::Vector2f &position) {
         }
       } else {
         // Иначе берем верхнюю карту и кладем ее в сброс
-        auto card = m_stockPile->removeTopCard();
-        card->flip(); // Переворачиваем карту лицевой стороной вверх
-        m_wastePile->addCard(card);
-
-        // Создаем команду для отмены
-        auto command = std::make_unique<MoveCardCommand>(this, card, m_stockPile,
-                                                         m_wastePile);
-        m_undoStack.push(std::move(command));
+        Move move = pileMove(m_stockPile.get(), m_wastePile.get(), 1);
+        executeMove(move);
+        auto card = m_wastePile->getTopCard();
 
         // Проигрываем звук переворота карты
         try {
@@ -741,7 +826,7 @@ void Game::handleMouseReleased(const sf::Vector2f &position) {
                 << std::endl;
     }
 
-    if (containsPos && canAdd) {
+    if (containsPos && canAdd && pile != m_dragSourcePile) {
       targetPile = pile;
       break;
     }
@@ -754,27 +839,15 @@ void Game::handleMouseReleased(const sf::Vector2f &position) {
                 << static_cast<int>(targetPile->getType()) << std::endl;
     }
 
-    // Добавляем карты в целевую стопку
+    // Карты возвращаются в исходную стопку и перекладываются обычным ходом,
+    // чтобы он попал в историю
     for (auto &card : m_draggedCards) {
       card->setDragging(false);
-      targetPile->addCard(card);
-    }
-
-    // Проверяем, нужно ли перевернуть карту в исходной стопке
-    bool flippedCardInSourcePile = false;
-    if (m_dragSourcePile->getType() == PileType::TABLEAU &&
-        !m_dragSourcePile->isEmpty()) {
-      auto topCard = m_dragSourcePile->getTopCard();
-      if (topCard && !topCard->isFaceUp()) {
-        topCard->flip();
-        flippedCardInSourcePile = true;
-      }
+      m_dragSourcePile->addCard(card);
     }
-
-    // Создаем команду для перемещения карт с флагом перевернутой карты
-    auto command = std::make_unique<MoveCardsCommand>(
-        this, m_draggedCards, m_dragSourcePile, targetPile,
-        flippedCardInSourcePile);
+    Move move = pileMove(m_dragSourcePile.get(), targetPile.get(),
+                         m_draggedCards.size());
+    executeMove(move);
 
     // Проигрываем звук размещения карты
     try {
@@ -792,9 +865,6 @@ void Game::handleMouseReleased(const sf::Vector2f &position) {
     // Увеличиваем счетчик ходов
     StatsManager::getInstance().incrementMoves();
 
-    // Добавляем команду в стек отмены
-    m_undoStack.push(std::move(command));
-
     // Примечание: убираем двойную проверку победы,
     // теперь она происходит только в методе update()
   } else {
@@ -831,11 +901,50 @@ bool Game::checkVictory() const {
   return true;
 }
 
-void Game::reset() {
-  // Очищаем стек отмены
-  while (!m_undoStack.empty()) {
-      m_undoStack.pop();
+void Game::recordResult(bool won) {
+  if (m_resultRecorded) {
+    return;
   }
+  m_resultRecorded = true;
+
+  HistoryRecord record;
+  record.dealNumber = m_dealNumber;
+  record.drawCount = captureBoard().drawCount;
+  record.won = won;
+  record.moves = static_cast<std::uint16_t>(
+      std::min(StatsManager::getInstance().getStats().currentMoves, 0xFFFF));
+  record.seconds = m_timer ? static_cast<std::uint32_t>(
+                                 std::max(0, m_timer->getElapsedSeconds()))
+                           : 0;
+  record.score = m_scoreSystem ? m_scoreSystem->getScore() : 0;
+  record.undos = static_cast<std::uint16_t>(std::min(m_undoCount, 0xFFFF));
+  record.hints = static_cast<std::uint16_t>(std::min(m_hintCount, 0xFFFF));
+  record.timestamp = static_cast<std::int64_t>(std::time(nullptr));
+  GameHistory::getInstance().append(record);
+  // Таблицы рекордов обновляются в своём потоке
+  Leaderboard::getInstance().submit(record);
+}
+
+void Game::reset() { reset(chooseDealNumber()); }
+
+void Game::reset(std::uint32_t dealNumber) {
+  finishCurrentGame();
+
+  // Инициализируем игру заново
+  initialize(dealNumber);
+
+  // Добавляем подписчиков заново (важно для повторных игр)
+  // Этот шаг необходим только если в notifyObservers() мы очищаем список
+}
+
+void Game::finishCurrentGame() {
+  // Брошенная партия тоже попадает в историю, пока таймер и счёт не сброшены
+  if (StatsManager::getInstance().getStats().currentMoves > 0) {
+    recordResult(false);
+  }
+
+  // Очищаем историю ходов
+  m_history.clear();
 
   m_popupImage.hide();
 
@@ -853,12 +962,6 @@ void Game::reset() {
 
   // Очищаем данные подсказки
   clearHint();
-
-  // Инициализируем игру заново
-  initialize();
-
-  // Добавляем подписчиков заново (важно для повторных игр)
-  // Этот шаг необходим только если в notifyObservers() мы очищаем список
 }
 
 void Game::undo() {
@@ -867,10 +970,17 @@ void Game::undo() {
     clearHint();
   }
 
-  if (!m_undoStack.empty()) {
-    auto command = std::move(m_undoStack.top());
-    m_undoStack.pop();
-    command->undo();
+  // Во время перетаскивания карты не лежат в стопках
+  if (!m_draggedCards.empty()) {
+    return;
+  }
+
+  if (m_history.canUndo()) {
+    Move move = m_history.popUndo();
+    revertMove(move);
+    ++m_undoCount;
+    m_replay.recordUndo(move);
+    m_journal.recordUndo(move);
 
     // Проигрываем звук отмены
     try {
@@ -881,38 +991,166 @@ void Game::undo() {
   }
 }
 
-void Game::moveCard(std::shared_ptr<Card> card,
-                    std::shared_ptr<Pile> sourcePile,
-                    std::shared_ptr<Pile> targetPile) {
-  if (targetPile->canAddCard(card)) {
-    sourcePile->removeTopCard();
-    targetPile->addCard(card);
+void Game::redo() {
+  if (m_showingHint) {
+    clearHint();
+  }
+  if (!m_draggedCards.empty() || !m_history.canRedo()) {
+    return;
+  }
+
+  Move move = m_history.popRedo();
+  performMove(move);
+  m_replay.recordMove(move);
+  m_journal.recordMove(move);
+
+  try {
+    SoundManager::getInstance().playSound(SoundEffect::CARD_PLACE);
+  } catch (...) {
+    std::cerr << "Не удалось проиграть звук повтора" << std::endl;
   }
 }
 
-// Новый метод для перемещения карты с управляемым переворотом следующей карты
-void Game::moveCardWithFlip(std::shared_ptr<Card> card,
-                            std::shared_ptr<Pile> sourcePile,
-                            std::shared_ptr<Pile> targetPile) {
-  if (targetPile->canAddCard(card)) {
-    // Запоминаем, можно ли перевернуть следующую карту
-    bool canFlipNextCard =
-        (sourcePile->getType() == PileType::TABLEAU && !sourcePile->isEmpty() &&
-         sourcePile->getCardCount() > 1);
+void Game::restoreHistory(const std::vector<Move> &moves) {
+  m_history.clear();
+  for (const Move &move : moves) {
+    m_history.push(move);
+  }
+}
 
-    // Удаляем верхнюю карту из исходной стопки
-    sourcePile->removeTopCard();
+SaveData Game::makeSaveData() const {
+  // Берём позицию из снимка, чтобы не потерять перетаскиваемые карты
+  SaveData data;
+  data.board = captureBoard();
+  data.dealNumber = m_dealNumber;
+  data.sequence = m_journal.getSequence();
+  data.moves = static_cast<std::uint32_t>(
+      std::max(0, StatsManager::getInstance().getStats().currentMoves));
+  data.undos = static_cast<std::uint16_t>(std::min(m_undoCount, 0xFFFF));
+  data.hints = static_cast<std::uint16_t>(std::min(m_hintCount, 0xFFFF));
+  if (m_timer) {
+    data.seconds =
+        static_cast<std::uint32_t>(std::max(0, m_timer->getElapsedSeconds()));
+  }
+  if (m_scoreSystem) {
+    data.score = m_scoreSystem->getScore();
+  }
+  data.history.reserve(m_history.getUndoCount());
+  for (size_t i = 0; i < m_history.getUndoCount(); ++i) {
+    data.history.push_back(m_history.getUndoMove(i));
+  }
+  return data;
+}
 
-    // Добавляем карту в целевую стопку
-    targetPile->addCard(card);
+bool Game::restoreSaveData(const SaveData &data) {
+  // Загруженная партия продолжается, а не начинается заново: ни события
+  // новой игры в статистике, ни записи 'G' в журнале; счётчики - из сохранения
+  finishCurrentGame();
+  setupDeal(data.dealNumber);
+  if (!applyBoard(data.board)) {
+    return false;
+  }
+  restoreHistory(data.history);
+  if (m_timer) {
+    m_timer->setElapsedSeconds(static_cast<int>(data.seconds));
+  }
+  if (m_scoreSystem) {
+    m_scoreSystem->setScore(data.score);
+  }
+  m_undoCount = data.undos;
+  m_hintCount = data.hints;
+  StatsManager::getInstance().gameResumed(
+      static_cast<int>(std::min<std::uint32_t>(data.moves, 0x7FFFFFFF)),
+      static_cast<int>(data.seconds), data.score);
+  startReplay();
+
+  // Журнал продолжает с загруженной позиции
+  m_journal.snapshot(makeSaveData());
+  return true;
+}
 
-    // Переворачиваем следующую карту, если нужно
-    if (canFlipNextCard) {
-      auto topCard = sourcePile->getTopCard();
-      if (topCard && !topCard->isFaceUp()) {
-        topCard->flip();
-      }
+void Game::startJournal(std::uint32_t sequence) {
+  if (m_journal.start(sequence)) {
+    m_journal.snapshot(makeSaveData());
+  } else {
+    std::cerr << "Не удалось запустить журнал партии" << std::endl;
+  }
+}
+
+Move Game::pileMove(const Pile *from, const Pile *to, size_t count) const {
+  Move move;
+  move.from = static_cast<std::uint8_t>(getPileIndex(from));
+  move.to = static_cast<std::uint8_t>(getPileIndex(to));
+  move.count = static_cast<std::uint8_t>(count);
+  return move;
+}
+
+bool Game::executeMove(Move &move) {
+  if (move.from >= m_piles.size() || move.to >= m_piles.size() ||
+      move.from == move.to || move.count == 0 ||
+      m_piles[move.from]->getCardCount() < move.count) {
+    return false;
+  }
+  performMove(move);
+  m_history.push(move);
+  m_replay.recordMove(move);
+  m_journal.recordMove(move);
+  return true;
+}
+
+void Game::performMove(Move &move) {
+  move.flags = 0;
+  Pile &source = *m_piles[move.from];
+  Pile &target = *m_piles[move.to];
+
+  // Взятие из колоды и переворот сброса: карты идут по одной
+  // и переворачиваются
+  if (move.isDraw() || move.isRecycle()) {
+    for (int i = 0; i < move.count && !source.isEmpty(); ++i) {
+      auto card = source.removeTopCard();
+      card->setFaceUp(move.isDraw());
+      target.addCard(card);
+    }
+    return;
+  }
+
+  source.transferCards(source.getCardCount() - move.count, target);
+
+  // Открываем карту, оказавшуюся сверху игровой стопки
+  if (source.getType() == PileType::TABLEAU && !source.isEmpty() &&
+      !source.getTopCard()->isFaceUp()) {
+    source.getTopCard()->flip();
+    move.flags |= Move::FLIPPED;
+  }
+}
+
+void Game::revertMove(const Move &move) {
+  Pile &source = *m_piles[move.from];
+  Pile &target = *m_piles[move.to];
+
+  if (move.isDraw() || move.isRecycle()) {
+    for (int i = 0; i < move.count && !target.isEmpty(); ++i) {
+      auto card = target.removeTopCard();
+      card->setFaceUp(move.isRecycle());
+      source.addCard(card);
     }
+    return;
+  }
+
+  if (move.flipped() && !source.isEmpty()) {
+    source.getTopCard()->setFaceUp(false);
+  }
+  if (target.getCardCount() >= move.count) {
+    target.transferCards(target.getCardCount() - move.count, source);
+  }
+}
+
+void Game::moveCard(std::shared_ptr<Card> card,
+                    std::shared_ptr<Pile> sourcePile,
+                    std::shared_ptr<Pile> targetPile) {
+  if (targetPile->canAddCard(card)) {
+    sourcePile->removeTopCard();
+    targetPile->addCard(card);
   }
 }
 
@@ -953,7 +1191,8 @@ bool Game::autoComplete() {
         // Ищем подходящий фундамент
         for (auto &foundation : m_foundationPiles) {
           if (foundation->canAddCard(topCard)) {
-            moveCardWithFlip(topCard, pile, foundation);
+            Move move = pileMove(pile.get(), foundation.get(), 1);
+            executeMove(move);
             moved = true;
             break;
           }
@@ -969,7 +1208,8 @@ bool Game::autoComplete() {
     auto topCard = m_wastePile->getTopCard();
     for (auto &foundation : m_foundationPiles) {
       if (foundation->canAddCard(topCard)) {
-        moveCardWithFlip(topCard, m_wastePile, foundation);
+        Move move = pileMove(m_wastePile.get(), foundation.get(), 1);
+        executeMove(move);
         moved = true;
         break;
       }
@@ -1000,186 +1240,18 @@ void Game::useHint() {
       return;
   }
 
-  // Структура для хранения подсказки (возможного хода)
-  struct Hint {
-      std::vector<std::shared_ptr<Card>> cards;
-      std::shared_ptr<Pile> sourcePile;
-      std::shared_ptr<Pile> targetPile;
-      int priority;
-  };
-
-  std::vector<Hint> possibleMoves;
-
-  // 1. Проверка перемещения из waste в foundation
-  if (!m_wastePile->isEmpty()) {
-      auto topCard = m_wastePile->getTopCard();
-      for (auto& foundation : m_foundationPiles) {
-          if (foundation->canAddCard(topCard)) {
-              std::vector<std::shared_ptr<Card>> cards = {topCard};
-              int priority = (topCard->getRank() == Rank::ACE) ? 5 : 4;
-              possibleMoves.push_back({cards, m_wastePile, foundation, priority});
-          }
-      }
-  }
-
-  // 2. Проверка перемещения из tableau в foundation
-  for (auto& tableau : m_tableauPiles) {
-      if (!tableau->isEmpty()) {
-          auto topCard = tableau->getTopCard();
-          if (topCard->isFaceUp()) {
-              for (auto& foundation : m_foundationPiles) {
-                  if (foundation->canAddCard(topCard)) {
-                      std::vector<std::shared_ptr<Card>> cards = {topCard};
-                      int priority = (topCard->getRank() == Rank::ACE) ? 5 : 4;
-                      possibleMoves.push_back({cards, tableau, foundation, priority});
-                  }
-              }
-          }
-      }
-  }
-
-  // 3. Проверка перемещения из waste в tableau
-  if (!m_wastePile->isEmpty()) {
-      auto card = m_wastePile->getTopCard();
-      for (auto& tableau : m_tableauPiles) {
-          if (tableau->canAddCard(card)) {
-              std::vector<std::shared_ptr<Card>> cards = {card};
-              int priority = 2;
-              // Если это король и стопка пуста, повышаем приоритет
-              if (card->getRank() == Rank::KING && tableau->isEmpty()) {
-                  priority = 3;
-              }
-              possibleMoves.push_back({cards, m_wastePile, tableau, priority});
-          }
-      }
-  }
-
-  // 4. Проверка перемещения между tableau с открытием карты
-  for (auto& sourceTableau : m_tableauPiles) {
-      if (sourceTableau->getCardCount() >= 2) {
-          // Проверяем, является ли предпоследняя карта закрытой
-          size_t secondLastIndex = sourceTableau->getCardCount() - 2;
-          auto secondLastCard = sourceTableau->getCardAt(secondLastIndex);
-          bool wouldFlipCard = !secondLastCard->isFaceUp();
-
-          if (wouldFlipCard) {
-              auto topCard = sourceTableau->getTopCard();
-              // Ищем куда можно переместить верхнюю карту
-              for (auto& targetTableau : m_tableauPiles) {
-                  if (targetTableau != sourceTableau && targetTableau->canAddCard(topCard)) {
-                      std::vector<std::shared_ptr<Card>> cards = {topCard};
-                      possibleMoves.push_back({cards, sourceTableau, targetTableau, 3});
-                  }
-              }
-          }
-      }
+  // Во время перетаскивания стопки не совпадают с позицией, подсказку не показываем
+  if (!m_draggedCards.empty()) {
+      return;
   }
+  ++m_hintCount;
 
-  // 5. Проверка перемещения последовательностей карт между tableau
-  for (auto& sourceTableau : m_tableauPiles) {
-      if (sourceTableau->isEmpty()) continue;
-
-      // Анализируем все возможные последовательности карт сверху вниз
-      size_t maxIndex = sourceTableau->getCardCount() - 1;
-
-      for (int startIndex = maxIndex; startIndex >= 0; startIndex--) {
-          auto startCard = sourceTableau->getCardAt(startIndex);
-
-          // Проверяем только открытые карты
-          if (!startCard->isFaceUp()) continue;
-
-          // Формируем последовательность от startIndex до верха
-          std::vector<std::shared_ptr<Card>> cardSequence;
-          for (int i = startIndex; i <= maxIndex; i++) {
-              cardSequence.push_back(sourceTableau->getCardAt(i));
-          }
-
-          // Проверяем, можно ли переместить эту последовательность
-          if (cardSequence.size() >= 1) {
-              for (auto& targetTableau : m_tableauPiles) {
-                  if (targetTableau != sourceTableau && targetTableau->canAddCard(cardSequence.front())) {
-                      // НОВОЕ: Проверяем, имеет ли смысл это перемещение
-                      bool hasStrategicValue = false;
-
-                      // 1. Определяем, будет ли открыта новая карта
-                      bool wouldFlipCard = (startIndex > 0 &&
-                                           !sourceTableau->getCardAt(startIndex - 1)->isFaceUp());
-
-                      if (wouldFlipCard) {
-                          hasStrategicValue = true; // Открытие новой карты всегда полезно
-                      }
-
-                      // 2. Проверяем, перемещаем ли мы короля на пустую стопку
-                      bool movingKingToEmpty = (cardSequence.front()->getRank() == Rank::KING &&
-                                               targetTableau->isEmpty());
-
-                      if (movingKingToEmpty) {
-                          hasStrategicValue = true; // Перемещение короля на пустую стопку может быть полезно
-                      }
-
-                      // 3. Проверяем, освобождает ли это ход место для карт из отбоя
-                      bool clearingSpaceForWaste = false;
-                      if (!m_wastePile->isEmpty()) {
-                          auto wasteCard = m_wastePile->getTopCard();
-                          // Если мы освобождаем место для карты из отбоя
-                          if (startIndex == 0 && sourceTableau->isEmpty() &&
-                              wasteCard->getRank() == Rank::KING) {
-                              clearingSpaceForWaste = true;
-                          }
-                      }
-
-                      if (clearingSpaceForWaste) {
-                          hasStrategicValue = true;
-                      }
-
-                      // 4. Перемещение длинной последовательности может быть стратегически полезно
-                      if (cardSequence.size() > 3) {
-                          hasStrategicValue = true; // Длинные последовательности стоит перемещать
-                      }
-
-                      // 5. Проверяем, не приводит ли перемещение к объединению последовательности
-                      // Например, если мы перемещаем 5 червей на 6 бубен, а в целевой стопке
-                      // есть последовательность до 6
-                      bool connectingSequences = false;
-                      if (!targetTableau->isEmpty()) {
-                          auto targetTopCard = targetTableau->getTopCard();
-                          auto sourceBottomCard = cardSequence.front();
-
-                          if (static_cast<int>(targetTopCard->getRank()) == static_cast<int>(sourceBottomCard->getRank()) + 1 &&
-                              ((targetTopCard->getSuit() == Suit::HEARTS ||
-                                targetTopCard->getSuit() == Suit::DIAMONDS) !=
-                               (sourceBottomCard->getSuit() == Suit::HEARTS ||
-                                sourceBottomCard->getSuit() == Suit::DIAMONDS))) {
-                              connectingSequences = true;
-                          }
-                      }
-
-                      if (connectingSequences) {
-                          hasStrategicValue = true;
-                      }
-
-                      // Добавляем ход только если он имеет стратегическую ценность
-                      if (hasStrategicValue) {
-                          int priority = 1; // Базовый приоритет
-
-                          if (wouldFlipCard) {
-                              priority = 3; // Высокий приоритет для открытия новой карты
-                          }
-
-                          if (movingKingToEmpty) {
-                              priority = wouldFlipCard ? 4 : 2;
-                          }
-
-                          possibleMoves.push_back({cardSequence, sourceTableau, targetTableau, priority});
-                      }
-                  }
-              }
-          }
-      }
-  }
+  // Первый ход с наибольшим приоритетом; кэш пересчитывает ходы
+  // только для стопок, изменившихся после прошлого запроса
+  const Move* bestMove = getHintCache().getBestHint();
 
   // Если нет других ходов, проверяем ситуацию с колодой
-  if (possibleMoves.empty()) {
+  if (!bestMove) {
       if (!m_stockPile->isEmpty()) {
           std::cout << "Подсказка: Возьмите карту из колоды." << std::endl;
 
@@ -1206,19 +1278,20 @@ void Game::useHint() {
       }
   }
 
-  // Сортируем ходы по приоритету (от высшего к низшему)
-  std::sort(possibleMoves.begin(), possibleMoves.end(),
-            [](const Hint& a, const Hint& b) { return a.priority > b.priority; });
-
-  // Выбираем лучший ход
-  const auto& bestMove = possibleMoves[0];
+  // Карты, которые нужно переместить
+  const auto& sourcePile = m_piles[bestMove->from];
+  const auto& targetPile = m_piles[bestMove->to];
+  m_hintCards.clear();
+  for (size_t i = sourcePile->getCardCount() - bestMove->count; i < sourcePile->getCardCount(); ++i) {
+      m_hintCards.push_back(sourcePile->getCardAt(i));
+  }
 
   // Текстовая подсказка
   std::cout << "Подсказка: Переместите ";
 
-  if (bestMove.cards.size() == 1) {
+  if (m_hintCards.size() == 1) {
       // Одна карта
-      auto card = bestMove.cards[0];
+      auto card = m_hintCards[0];
       if (static_cast<int>(card->getRank()) >= 2 && static_cast<int>(card->getRank()) <= 10) {
           std::cout << static_cast<int>(card->getRank());
       } else if (static_cast<int>(card->getRank()) == 1) {
@@ -1241,12 +1314,12 @@ void Game::useHint() {
       }
   } else {
       // Последовательность карт
-      std::cout << "последовательность из " << bestMove.cards.size() << " карт";
+      std::cout << "последовательность из " << m_hintCards.size() << " карт";
   }
 
   std::cout << " на ";
 
-  switch (bestMove.targetPile->getType()) {
+  switch (targetPile->getType()) {
       case PileType::FOUNDATION: std::cout << "фундамент"; break;
       case PileType::TABLEAU: std::cout << "игровую стопку"; break;
       default: std::cout << "другую стопку"; break;
@@ -1255,10 +1328,9 @@ void Game::useHint() {
   std::cout << std::endl;
 
   // Визуальная анимация подсказки
-  m_hintSourceCard = bestMove.cards[0];
-  m_hintSourcePile = bestMove.sourcePile;
-  m_hintTargetPile = bestMove.targetPile;
-  m_hintCards = bestMove.cards;
+  m_hintSourceCard = m_hintCards[0];
+  m_hintSourcePile = sourcePile;
+  m_hintTargetPile = targetPile;
   m_hintPulseLevel = 0.0f;
   m_hintClock.restart();
   m_showingHint = true;
@@ -0,0 +1,319 @@
+#include "GameHistory.hpp"
+#include "BinaryIO.hpp"
+#include <algorithm>
+#include <cstring>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <io.h>
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+static const char MAGIC[4] = {'K', 'H', 'S', 'T'};
+static const std::uint32_t VERSION = 1;
+static const std::size_t HEADER_SIZE = 32;
+static const std::size_t ROWS = GameHistory::BLOCK_ROWS;
+
+// Смещения столбцов внутри блока
+static const std::size_t COL_TIME = 0;
+static const std::size_t COL_DEAL = 8 * ROWS;
+static const std::size_t COL_SECONDS = 12 * ROWS;
+static const std::size_t COL_SCORE = 16 * ROWS;
+static const std::size_t COL_MOVES = 20 * ROWS;
+static const std::size_t COL_UNDOS = 22 * ROWS;
+static const std::size_t COL_HINTS = 24 * ROWS;
+static const std::size_t COL_VARIANT = 26 * ROWS;
+static const std::size_t COL_WON = 27 * ROWS;
+static const std::size_t BLOCK_SIZE = 28 * ROWS;
+
+const char* const GameHistory::DEFAULT_PATH = "history.db";
+const std::size_t GameHistory::BLOCK_ROWS;
+
+static bool writeAt(std::FILE* file, std::size_t offset, const unsigned char* bytes, std::size_t size) {
+    return std::fseek(file, static_cast<long>(offset), SEEK_SET) == 0 &&
+           std::fwrite(bytes, 1, size, file) == size;
+}
+
+static bool writeField(std::FILE* file, std::size_t offset, std::uint64_t value, std::size_t width) {
+    unsigned char bytes[8];
+    for (std::size_t i = 0; i < width; ++i) {
+        bytes[i] = static_cast<unsigned char>(value >> (8 * i));
+    }
+    return writeAt(file, offset, bytes, width);
+}
+
+GameHistory& GameHistory::getInstance() {
+    static GameHistory instance;
+    static bool triedOpen = false;
+    if (!triedOpen) {
+        triedOpen = true;
+        instance.open(DEFAULT_PATH);
+    }
+    return instance;
+}
+
+GameHistory::GameHistory() : m_file(nullptr), m_mapping(nullptr), m_mappingSize(0), m_rowCount(0) {
+}
+
+GameHistory::~GameHistory() {
+    close();
+}
+
+bool GameHistory::open(const std::string& path) {
+    close();
+
+    m_file = std::fopen(path.c_str(), "r+b");
+    if (!m_file) {
+        m_file = std::fopen(path.c_str(), "w+b");
+        unsigned char header[HEADER_SIZE] = {};
+        std::memcpy(header, MAGIC, sizeof(MAGIC));
+        writeU32(header + 4, VERSION);
+        writeU32(header + 8, static_cast<std::uint32_t>(ROWS));
+        if (!m_file || !writeAt(m_file, 0, header, sizeof(header)) || std::fflush(m_file) != 0) {
+            close();
+            return false;
+        }
+    }
+
+    unsigned char header[HEADER_SIZE];
+    if (std::fseek(m_file, 0, SEEK_END) != 0) {
+        close();
+        return false;
+    }
+    long fileSize = std::ftell(m_file);
+    if (fileSize < static_cast<long>(HEADER_SIZE) || std::fseek(m_file, 0, SEEK_SET) != 0 ||
+        std::fread(header, 1, sizeof(header), m_file) != sizeof(header) ||
+        std::memcmp(header, MAGIC, sizeof(MAGIC)) != 0 || readU32(header + 4) != VERSION ||
+        readU32(header + 8) != ROWS) {
+        close();
+        return false;
+    }
+
+    // Строки без блока на диске - след оборванной записи
+    std::size_t blocks = (static_cast<std::size_t>(fileSize) - HEADER_SIZE) / BLOCK_SIZE;
+    m_rowCount = std::min<std::size_t>(readU32(header + 12), blocks * ROWS);
+    if (!map(static_cast<std::size_t>(fileSize))) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void GameHistory::close() {
+    unmap();
+    if (m_file) {
+        std::fclose(m_file);
+        m_file = nullptr;
+    }
+    m_rowCount = 0;
+}
+
+bool GameHistory::map(std::size_t size) {
+    unmap();
+    if (size <= HEADER_SIZE) {
+        return true;
+    }
+
+    // Файл открыт и на запись, поэтому отображение только для чтения
+    // со свободным доступом; дописанное видно через него после fflush
+#ifdef _WIN32
+    HANDLE file = reinterpret_cast<HANDLE>(_get_osfhandle(_fileno(m_file)));
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+        return false;
+    }
+    void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, size);
+    CloseHandle(mapping);
+    if (!data) {
+        return false;
+    }
+#else
+    void* data = mmap(nullptr, size, PROT_READ, MAP_SHARED, fileno(m_file), 0);
+    if (data == MAP_FAILED) {
+        return false;
+    }
+#endif
+    m_mapping = data;
+    m_mappingSize = size;
+    return true;
+}
+
+void GameHistory::unmap() {
+    if (m_mapping) {
+#ifdef _WIN32
+        UnmapViewOfFile(m_mapping);
+#else
+        munmap(m_mapping, m_mappingSize);
+#endif
+    }
+    m_mapping = nullptr;
+    m_mappingSize = 0;
+}
+
+bool GameHistory::append(const HistoryRecord& record) {
+    if (!m_file) {
+        return false;
+    }
+
+    std::size_t block = m_rowCount / ROWS;
+    std::size_t row = m_rowCount % ROWS;
+    std::size_t base = HEADER_SIZE + block * BLOCK_SIZE;
+    bool newBlock = row == 0;
+    if (newBlock) {
+        static const std::vector<unsigned char> zeros(BLOCK_SIZE, 0);
+        if (!writeAt(m_file, base, zeros.data(), zeros.size())) {
+            return false;
+        }
+    }
+
+    // Без fsync: история - не сохранение, и победный кадр не ждёт диска
+    bool written = writeField(m_file, base + COL_TIME + row * 8, static_cast<std::uint64_t>(record.timestamp), 8) &&
+                   writeField(m_file, base + COL_DEAL + row * 4, record.dealNumber, 4) &&
+                   writeField(m_file, base + COL_SECONDS + row * 4, record.seconds, 4) &&
+                   writeField(m_file, base + COL_SCORE + row * 4, static_cast<std::uint32_t>(record.score), 4) &&
+                   writeField(m_file, base + COL_MOVES + row * 2, record.moves, 2) &&
+                   writeField(m_file, base + COL_UNDOS + row * 2, record.undos, 2) &&
+                   writeField(m_file, base + COL_HINTS + row * 2, record.hints, 2) &&
+                   writeField(m_file, base + COL_VARIANT + row, record.drawCount, 1) &&
+                   writeField(m_file, base + COL_WON + row, record.won ? 1 : 0, 1) &&
+                   std::fflush(m_file) == 0 &&
+                   writeField(m_file, 12, m_rowCount + 1, 4) && std::fflush(m_file) == 0;
+    if (!written) {
+        return false;
+    }
+    ++m_rowCount;
+
+    // Файл вырос на блок - отображение пересоздаётся
+    if (newBlock) {
+        return map(base + BLOCK_SIZE);
+    }
+    return true;
+}
+
+HistoryRecord GameHistory::getRecord(std::size_t row) const {
+    HistoryRecord record;
+    if (row >= m_rowCount || !m_mapping) {
+        return record;
+    }
+    const unsigned char* base = static_cast<const unsigned char*>(m_mapping) + HEADER_SIZE + (row / ROWS) * BLOCK_SIZE;
+    std::size_t i = row % ROWS;
+    record.timestamp = static_cast<std::int64_t>(readU64(base + COL_TIME + i * 8));
+    record.dealNumber = readU32(base + COL_DEAL + i * 4);
+    record.seconds = readU32(base + COL_SECONDS + i * 4);
+    record.score = static_cast<std::int32_t>(readU32(base + COL_SCORE + i * 4));
+    record.moves = readU16(base + COL_MOVES + i * 2);
+    record.undos = readU16(base + COL_UNDOS + i * 2);
+    record.hints = readU16(base + COL_HINTS + i * 2);
+    record.drawCount = base[COL_VARIANT + i];
+    record.won = base[COL_WON + i] != 0;
+    return record;
+}
+
+// Подходит ли строка i блока base под фильтр (кроме числа последних партий)
+static bool matches(const HistoryFilter& filter, const unsigned char* base, std::size_t i) {
+    return (filter.drawCount == 0 || base[COL_VARIANT + i] == filter.drawCount) &&
+           (filter.since == 0 || static_cast<std::int64_t>(readU64(base + COL_TIME + i * 8)) >= filter.since);
+}
+
+template <typename Visitor>
+void GameHistory::scan(const HistoryFilter& filter, Visitor visit) const {
+    if (!m_mapping || m_rowCount == 0) {
+        return;
+    }
+    std::size_t first = 0;
+    if (filter.lastGames != 0 && filter.lastGames < m_rowCount) {
+        first = m_rowCount - filter.lastGames;
+    }
+
+    const unsigned char* data = static_cast<const unsigned char*>(m_mapping) + HEADER_SIZE;
+    for (std::size_t block = first / ROWS; block * ROWS < m_rowCount; ++block) {
+        std::size_t begin = block * ROWS < first ? first - block * ROWS : 0;
+        std::size_t end = std::min(ROWS, m_rowCount - block * ROWS);
+        visit(data + block * BLOCK_SIZE, begin, end);
+    }
+}
+
+// Добавляет строку i блока base в итоги; без ветвлений по исходу партии,
+// чтобы проход по столбцам не спотыкался о случайные победы и поражения
+static void accumulate(HistorySummary& summary, const unsigned char* base, std::size_t i) {
+    std::int32_t score = static_cast<std::int32_t>(readU32(base + COL_SCORE + i * 4));
+    summary.bestScore = summary.games == 0 ? score : std::max(summary.bestScore, score);
+    ++summary.games;
+    summary.undos += readU16(base + COL_UNDOS + i * 2);
+    summary.hints += readU16(base + COL_HINTS + i * 2);
+    std::uint32_t won = base[COL_WON + i] ? 1u : 0u;
+    summary.wins += won;
+    summary.moves += readU16(base + COL_MOVES + i * 2) & (0u - won);
+    summary.winSeconds += readU32(base + COL_SECONDS + i * 4) & (0u - won);
+}
+
+static void merge(HistorySummary& summary, const HistorySummary& part) {
+    if (part.games == 0) {
+        return;
+    }
+    summary.bestScore = summary.games == 0 ? part.bestScore : std::max(summary.bestScore, part.bestScore);
+    summary.games += part.games;
+    summary.wins += part.wins;
+    summary.moves += part.moves;
+    summary.winSeconds += part.winSeconds;
+    summary.undos += part.undos;
+    summary.hints += part.hints;
+}
+
+HistorySummary GameHistory::summarize(const HistoryFilter& filter) const {
+    HistorySummary summary;
+    scan(filter, [&summary, &filter](const unsigned char* base, std::size_t begin, std::size_t end) {
+        // Итоги и фильтр в локальных копиях: чтение байтов файла может
+        // указывать куда угодно, и иначе они перечитывались бы на каждой строке
+        HistorySummary part;
+        const HistoryFilter local = filter;
+        for (std::size_t i = begin; i < end; ++i) {
+            if (matches(local, base, i)) {
+                accumulate(part, base, i);
+            }
+        }
+        merge(summary, part);
+    });
+    return summary;
+}
+
+std::uint32_t GameHistory::medianWinSeconds(const HistoryFilter& filter) const {
+    std::vector<std::uint32_t> seconds;
+    scan(filter, [&seconds, &filter](const unsigned char* base, std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i) {
+            if (base[COL_WON + i] && matches(filter, base, i)) {
+                seconds.push_back(readU32(base + COL_SECONDS + i * 4));
+            }
+        }
+    });
+    if (seconds.empty()) {
+        return 0;
+    }
+    auto middle = seconds.begin() + seconds.size() / 2;
+    std::nth_element(seconds.begin(), middle, seconds.end());
+    return *middle;
+}
+
+std::vector<HistorySummary> GameHistory::trend(const HistoryFilter& filter, std::size_t groupSize) const {
+    std::vector<HistorySummary> groups;
+    if (groupSize == 0) {
+        return groups;
+    }
+    scan(filter, [&groups, &filter, groupSize](const unsigned char* base, std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i) {
+            if (!matches(filter, base, i)) {
+                continue;
+            }
+            if (groups.empty() || groups.back().games == groupSize) {
+                groups.emplace_back();
+            }
+            accumulate(groups.back(), base, i);
+        }
+    });
+    return groups;
+}
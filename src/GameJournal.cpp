@@ -0,0 +1,295 @@
+#include "GameJournal.hpp"
+#include "BinaryIO.hpp"
+#include "Deal.hpp"
+#include "UndoHistory.hpp"
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <system_error>
+
+static const char MAGIC[4] = {'K', 'J', 'N', 'L'};
+static const std::uint32_t VERSION = 1;
+static const std::size_t HEADER_SIZE = 8;
+static const std::size_t RECORD_SIZE = 20;
+
+const char* const GameJournal::DEFAULT_JOURNAL_PATH = "savegame.journal";
+const char* const GameJournal::DEFAULT_SNAPSHOT_PATH = "savegame.snapshot";
+const int GameJournal::SYNC_INTERVAL_MS;
+const std::uint32_t GameJournal::SNAPSHOT_INTERVAL;
+
+static std::uint32_t recordSequence(const unsigned char* record) {
+    return readU32(record + 12);
+}
+
+GameJournal::GameJournal(const std::string& journalPath, const std::string& snapshotPath)
+    : m_journalPath(journalPath), m_snapshotPath(snapshotPath), m_sequence(0), m_snapshotSequence(0),
+      m_snapshotRequested(false), m_hasPendingSnapshot(false), m_stopping(false), m_file(nullptr) {
+}
+
+GameJournal::~GameJournal() {
+    stop();
+}
+
+bool GameJournal::start(std::uint32_t sequence) {
+    stop();
+    m_uncommitted.clear();
+    // Первый снимок получает свой номер: он новее любого файла на диске
+    m_sequence = sequence + 1;
+    m_snapshotSequence = m_sequence;
+    m_snapshotRequested = true;
+    m_pending.clear();
+    m_hasPendingSnapshot = false;
+    m_stopping = false;
+    m_written.clear();
+
+    // Файл журнала откроется после первого снимка: до этого старый журнал
+    // ещё нужен для восстановления
+    try {
+        m_thread = std::thread(&GameJournal::writerLoop, this);
+    } catch (const std::system_error&) {
+        return false;
+    }
+    return true;
+}
+
+void GameJournal::stop() {
+    if (!m_thread.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_wake.notify_one();
+    m_thread.join();
+    if (m_file) {
+        std::fclose(m_file);
+        m_file = nullptr;
+    }
+}
+
+void GameJournal::recordMove(const Move& move) {
+    queue('M', move, 0);
+}
+
+void GameJournal::recordUndo(const Move& move) {
+    queue('U', move, 0);
+}
+
+void GameJournal::recordNewGame(std::uint32_t dealNumber) {
+    queue('G', Move(), dealNumber);
+}
+
+void GameJournal::queue(char kind, const Move& move, std::uint32_t dealNumber) {
+    if (isRunning()) {
+        m_uncommitted.push_back({kind, move, dealNumber});
+    }
+}
+
+void GameJournal::commit(int seconds, int score) {
+    if (m_uncommitted.empty()) {
+        return;
+    }
+
+    std::uint32_t clampedSeconds = seconds < 0 ? 0 : (seconds > 0xFFFFFF ? 0xFFFFFF : static_cast<std::uint32_t>(seconds));
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const Record& entry : m_uncommitted) {
+        unsigned char record[RECORD_SIZE];
+        record[0] = static_cast<unsigned char>(entry.kind);
+        if (entry.kind == 'G') {
+            writeU32(record + 1, entry.dealNumber);
+        } else {
+            record[1] = entry.move.from;
+            record[2] = entry.move.to;
+            record[3] = entry.move.count;
+            record[4] = entry.move.flags;
+        }
+        record[5] = static_cast<unsigned char>(clampedSeconds);
+        record[6] = static_cast<unsigned char>(clampedSeconds >> 8);
+        record[7] = static_cast<unsigned char>(clampedSeconds >> 16);
+        writeU32(record + 8, static_cast<std::uint32_t>(score));
+        writeU32(record + 12, ++m_sequence);
+        writeU32(record + 16, crc32(record, 16));
+        m_pending.insert(m_pending.end(), record, record + RECORD_SIZE);
+    }
+    m_uncommitted.clear();
+    m_wake.notify_one();
+}
+
+bool GameJournal::wantsSnapshot() const {
+    return isRunning() && (m_snapshotRequested || m_sequence - m_snapshotSequence >= SNAPSHOT_INTERVAL);
+}
+
+void GameJournal::snapshot(SaveData data) {
+    if (!isRunning()) {
+        return;
+    }
+    commit(static_cast<int>(data.seconds), data.score);
+    data.sequence = m_sequence;
+    m_snapshotSequence = m_sequence;
+    m_snapshotRequested = false;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pendingSnapshot = std::move(data);
+        m_hasPendingSnapshot = true;
+    }
+    m_wake.notify_one();
+}
+
+void GameJournal::writerLoop() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+        m_wake.wait(lock, [this] { return m_stopping || m_hasPendingSnapshot || !m_pending.empty(); });
+
+        // Копим ходы, чтобы один fsync покрыл всю пачку
+        if (!m_stopping && !m_hasPendingSnapshot) {
+            m_wake.wait_for(lock, std::chrono::milliseconds(SYNC_INTERVAL_MS),
+                            [this] { return m_stopping || m_hasPendingSnapshot; });
+        }
+
+        std::vector<unsigned char> records;
+        records.swap(m_pending);
+        bool hasSnapshot = m_hasPendingSnapshot;
+        SaveData snapshot;
+        if (hasSnapshot) {
+            snapshot = std::move(m_pendingSnapshot);
+            m_hasPendingSnapshot = false;
+        }
+        bool stopping = m_stopping;
+        lock.unlock();
+
+        if (!records.empty()) {
+            appendRecords(records);
+        }
+        if (hasSnapshot) {
+            writeSnapshot(snapshot);
+        }
+
+        lock.lock();
+        if (stopping && m_pending.empty() && !m_hasPendingSnapshot) {
+            break;
+        }
+    }
+}
+
+bool GameJournal::appendRecords(const std::vector<unsigned char>& records) {
+    m_written.insert(m_written.end(), records.begin(), records.end());
+    if (!m_file) {
+        return false;
+    }
+    return std::fwrite(records.data(), 1, records.size(), m_file) == records.size() && syncFile(m_file);
+}
+
+bool GameJournal::writeSnapshot(const SaveData& data) {
+    if (!writeSaveFile(m_snapshotPath, data)) {
+        return false;
+    }
+
+    // Снимок на диске - в журнале остаются только более новые записи
+    std::vector<unsigned char> newer;
+    for (std::size_t offset = 0; offset + RECORD_SIZE <= m_written.size(); offset += RECORD_SIZE) {
+        const unsigned char* record = m_written.data() + offset;
+        if (recordSequence(record) > data.sequence) {
+            newer.insert(newer.end(), record, record + RECORD_SIZE);
+        }
+    }
+    m_written.swap(newer);
+    return openJournal(m_written);
+}
+
+bool GameJournal::openJournal(const std::vector<unsigned char>& records) {
+    if (m_file) {
+        std::fclose(m_file);
+        m_file = nullptr;
+    }
+
+    // Новый журнал: заголовок и записи новее снимка
+    std::vector<unsigned char> bytes(HEADER_SIZE);
+    std::memcpy(bytes.data(), MAGIC, sizeof(MAGIC));
+    writeU32(bytes.data() + 4, VERSION);
+    bytes.insert(bytes.end(), records.begin(), records.end());
+    if (!writeFileAtomic(m_journalPath, bytes)) {
+        return false;
+    }
+    m_file = std::fopen(m_journalPath.c_str(), "ab");
+    return m_file != nullptr;
+}
+
+std::size_t GameJournal::recover(const std::string& journalPath, SaveData& data, bool hasBase) {
+    std::ifstream file(journalPath, std::ios::binary);
+    if (!file) {
+        return 0;
+    }
+    std::vector<unsigned char> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (bytes.size() < HEADER_SIZE || std::memcmp(bytes.data(), MAGIC, sizeof(MAGIC)) != 0 ||
+        readU32(bytes.data() + 4) != VERSION) {
+        return 0;
+    }
+
+    std::size_t applied = 0;
+    for (std::size_t offset = HEADER_SIZE; offset + RECORD_SIZE <= bytes.size(); offset += RECORD_SIZE) {
+        const unsigned char* record = bytes.data() + offset;
+        if (crc32(record, 16) != readU32(record + 16)) {
+            // Оборванная при сбое запись
+            break;
+        }
+        char kind = static_cast<char>(record[0]);
+        std::uint32_t sequence = recordSequence(record);
+        if (hasBase && sequence <= data.sequence) {
+            // Уже в снимке
+            continue;
+        }
+        if (!hasBase && kind != 'G') {
+            continue;
+        }
+        if (hasBase && sequence != data.sequence + 1) {
+            break;
+        }
+
+        Move move;
+        move.from = record[1];
+        move.to = record[2];
+        move.count = record[3];
+        move.flags = record[4];
+        if (kind == 'G') {
+            data.dealNumber = readU32(record + 1);
+            data.board = dealBoard(data.dealNumber);
+            data.history.clear();
+            data.moves = 0;
+            data.undos = 0;
+            data.hints = 0;
+            hasBase = true;
+        } else if (kind == 'M') {
+            if (!isLegalMove(data.board, move)) {
+                break;
+            }
+            applyMove(data.board, move);
+            if (data.history.size() == UndoHistory::DEFAULT_CAPACITY) {
+                data.history.erase(data.history.begin());
+            }
+            data.history.push_back(move);
+            ++data.moves;
+        } else if (kind == 'U') {
+            // Отменяется только последний ход истории
+            if (data.history.empty() || data.history.back() != move ||
+                data.history.back().flags != move.flags || !undoMoveChecked(data.board, move)) {
+                break;
+            }
+            data.history.pop_back();
+            if (data.undos < 0xFFFF) {
+                ++data.undos;
+            }
+        } else {
+            break;
+        }
+
+        data.seconds = record[5] | (static_cast<std::uint32_t>(record[6]) << 8) |
+                       (static_cast<std::uint32_t>(record[7]) << 16);
+        data.score = static_cast<std::int32_t>(readU32(record + 8));
+        data.sequence = sequence;
+        ++applied;
+    }
+    return applied;
+}
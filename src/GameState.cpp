@@ -5,6 +5,9 @@
 #include "SoundManager.hpp"
 #include "SaveManager.hpp"
 #include "StatsManager.hpp"
+#include "GameHistory.hpp"
+#include "Leaderboard.hpp"
+#include "Game.hpp"
 #include "Context.hpp"
 #include "AnimationManager.hpp"
 #include "SettingsManager.hpp"
@@ -200,6 +203,11 @@ void MenuState::update(sf::Time deltaTime, Game& game) {
     m_cardDecor.setRotation(cardRotation);
 }
 
+// Декоративная карта покачивается постоянно
+bool MenuState::isAnimating(const Game& game) const {
+    return true;
+}
+
 void MenuState::updateButtonState(sf::RectangleShape& button, sf::Text& text,
                                   bool isSelected, float pulse) {
     if (isSelected) {
@@ -282,7 +290,9 @@ void MenuState::render(sf::RenderWindow& window, Game& game) {
 }
 
 // PlayingState
-PlayingState::PlayingState() {
+PlayingState::PlayingState()
+    : m_tableLayerBuilt(false), m_tableLayerFailed(false), m_tableVersion(0), m_tableBackground(nullptr),
+      m_tableDebug(false) {
     // Инициализируем фон
     updateBackground();
 
@@ -290,52 +300,18 @@ PlayingState::PlayingState() {
     sf::Font& font = resources.getFont();
 
     // Кнопки в игре
-    m_undoText.setFont(font);
-    m_undoText.setString("Cancel");
-    m_undoText.setCharacterSize(24);
-    m_undoText.setFillColor(sf::Color::White);
-    m_undoText.setPosition(50.0f, 700.0f);
-
-    m_resetText.setFont(font);
-    m_resetText.setString("Start Again");
-    m_resetText.setCharacterSize(24);
-    m_resetText.setFillColor(sf::Color::White);
-    m_resetText.setPosition(200.0f, 700.0f);
-
-    m_menuText.setFont(font);
-    m_menuText.setString("Menu");
-    m_menuText.setCharacterSize(24);
-    m_menuText.setFillColor(sf::Color::White);
-    m_menuText.setPosition(400.0f, 700.0f);
-
-    m_hintText.setFont(font);
-    m_hintText.setString("Hint");
-    m_hintText.setCharacterSize(24);
-    m_hintText.setFillColor(sf::Color::White);
-    m_hintText.setPosition(500.0f, 700.0f);
-
-    m_autoCompleteText.setFont(font);
-    m_autoCompleteText.setString("Auto Completion");
-    m_autoCompleteText.setCharacterSize(24);
-    m_autoCompleteText.setFillColor(sf::Color::White);
-    m_autoCompleteText.setPosition(650.0f, 700.0f);
+    m_undoText.init(font, "Cancel", 24, sf::Vector2f(50.0f, 700.0f));
+    m_resetText.init(font, "Start Again", 24, sf::Vector2f(200.0f, 700.0f));
+    m_menuText.init(font, "Menu", 24, sf::Vector2f(400.0f, 700.0f));
+    m_hintText.init(font, "Hint", 24, sf::Vector2f(500.0f, 700.0f));
+    m_autoCompleteText.init(font, "Auto Completion", 24, sf::Vector2f(650.0f, 700.0f));
 
     // Добавляем кнопку выбора фона
-    m_backgroundText.setFont(font);
-    m_backgroundText.setString("Background");
-    m_backgroundText.setCharacterSize(24);
-    m_backgroundText.setFillColor(sf::Color::White);
-    m_backgroundText.setPosition(850.0f, 700.0f);
+    m_backgroundText.init(font, "Background", 24, sf::Vector2f(850.0f, 700.0f));
 
-    m_timerText.setFont(font);
-    m_timerText.setCharacterSize(24);
-    m_timerText.setFillColor(sf::Color::White);
-    m_timerText.setPosition(50.0f, 10.0f);
-
-    m_scoreText.setFont(font);
-    m_scoreText.setCharacterSize(24);
-    m_scoreText.setFillColor(sf::Color::White);
-    m_scoreText.setPosition(250.0f, 10.0f);
+    // Время и счёт: строка задаётся в update() при смене значения
+    m_timerText.init(font, "", 24, sf::Vector2f(50.0f, 10.0f));
+    m_scoreText.init(font, "", 24, sf::Vector2f(250.0f, 10.0f));
 
     m_undoSelected = false;
     m_resetSelected = false;
@@ -468,36 +444,94 @@ void PlayingState::update(sf::Time deltaTime, Game& game) {
     game.update(deltaTime);
 
     // Обновляем цвета кнопок
-    m_undoText.setFillColor(m_undoSelected ? sf::Color::Yellow : sf::Color::White);
-    m_resetText.setFillColor(m_resetSelected ? sf::Color::Yellow : sf::Color::White);
-    m_menuText.setFillColor(m_menuSelected ? sf::Color::Yellow : sf::Color::White);
-    m_hintText.setFillColor(m_hintSelected ? sf::Color::Yellow : sf::Color::White);
-    m_autoCompleteText.setFillColor(m_autoCompleteSelected ? sf::Color::Yellow : sf::Color::White);
-    m_backgroundText.setFillColor(m_backgroundSelected ? sf::Color::Yellow : sf::Color::White);
-
-    // Обновляем текст таймера
-    if (game.getTimer()) {
-        m_timerText.setString("Time: " + game.getTimer()->getFormattedTime());
+    m_undoText.setHighlighted(m_undoSelected);
+    m_resetText.setHighlighted(m_resetSelected);
+    m_menuText.setHighlighted(m_menuSelected);
+    m_hintText.setHighlighted(m_hintSelected);
+    m_autoCompleteText.setHighlighted(m_autoCompleteSelected);
+    m_backgroundText.setHighlighted(m_backgroundSelected);
+
+    // Обновляем текст таймера - строка строится раз в секунду
+    if (const GameTimer* timer = game.getTimer()) {
+        m_timerText.setValue(timer->getElapsedSeconds(),
+                             [timer](std::int64_t) { return "Time: " + timer->getFormattedTime(); });
     }
 
     // Обновляем текст счета
     if (game.getScoreSystem()) {
-        m_scoreText.setString("Score: " + std::to_string(game.getScoreSystem()->getScore()));
+        m_scoreText.setValue(game.getScoreSystem()->getScore(),
+                             [](std::int64_t score) { return "Score: " + std::to_string(score); });
     }
 
     // Обновляем селектор фона
     m_backgroundSelector.update();
 }
 
-void PlayingState::render(sf::RenderWindow& window, Game& game) {
-    // Масштабируем фон под размер окна
+bool PlayingState::isAnimating(const Game& game) const {
+    return game.isAnimating();
+}
+
+bool PlayingState::updateTableLayer(sf::RenderWindow& window, Game& game) {
+    if (m_tableLayerFailed) {
+        return false;
+    }
+
+    const sf::View& view = window.getView();
+    const sf::Color tableColor = SettingsManager::getInstance().getSettings().tableColor;
+    unsigned tableVersion = game.refreshTable();
+    if (m_tableLayerBuilt && tableVersion == m_tableVersion &&
+        m_backgroundSprite.getTexture() == m_tableBackground && window.getSize() == m_tableWindowSize &&
+        view.getSize() == m_tableViewSize && view.getCenter() == m_tableViewCenter &&
+        tableColor == m_tableColor && Card::isDebugMode() == m_tableDebug) {
+        return true;
+    }
+
+    // Слой в координатах вида окна, чтобы спрайт ложился ровно на место стола
+    sf::Vector2u layerSize(static_cast<unsigned>(view.getSize().x), static_cast<unsigned>(view.getSize().y));
+    if (!m_tableLayerBuilt || m_tableLayer.getSize() != layerSize) {
+        if (!m_tableLayer.create(layerSize.x, layerSize.y)) {
+            std::cerr << "Не удалось создать слой стола, стол рисуется каждый кадр" << std::endl;
+            m_tableLayerFailed = true;
+            return false;
+        }
+    }
+    m_tableLayer.setView(view);
+
     adjustBackgroundScale(window);
+    m_tableLayer.clear(tableColor);
+    m_tableLayer.draw(m_backgroundSprite);
+    game.drawTable(m_tableLayer);
+    m_tableLayer.display();
+
+    m_tableSprite.setTexture(m_tableLayer.getTexture(), true);
+    m_tableSprite.setPosition(view.getCenter() - view.getSize() / 2.0f);
+
+    m_tableLayerBuilt = true;
+    m_tableVersion = tableVersion;
+    m_tableBackground = m_backgroundSprite.getTexture();
+    m_tableWindowSize = window.getSize();
+    m_tableViewSize = view.getSize();
+    m_tableViewCenter = view.getCenter();
+    m_tableColor = tableColor;
+    m_tableDebug = Card::isDebugMode();
+    return true;
+}
 
-    // Рисуем фон первым
-    window.draw(m_backgroundSprite);
+void PlayingState::render(sf::RenderWindow& window, Game& game) {
+    if (updateTableLayer(window, game)) {
+        // Фон и лежащие карты - одним готовым слоем
+        window.draw(m_tableSprite);
+    } else {
+        // Масштабируем фон под размер окна
+        adjustBackgroundScale(window);
 
-    // Рисуем игру
-    game.draw(window);
+        // Рисуем фон первым
+        window.draw(m_backgroundSprite);
+        game.drawTable(window);
+    }
+
+    // Подсказка, перетаскиваемые карты и всплывающее изображение
+    game.drawOverlay(window);
 
     // Рисуем кнопки и информацию
     window.draw(m_undoText);
@@ -617,6 +651,11 @@ void VictoryState::update(sf::Time deltaTime, Game& game) {
     }
 }
 
+// Текст победы пульсирует
+bool VictoryState::isAnimating(const Game& game) const {
+    return true;
+}
+
 void VictoryState::render(sf::RenderWindow& window, Game& game) {
     // Масштабируем фон под размер окна
     adjustBackgroundScale(window);
@@ -668,7 +707,7 @@ RulesState::RulesState() {
 "7. Controls:\n"
 "   - Left-click on the stock pile - draw a card\n"
 "   - Left-click and drag - move a card\n"
-"   - \"Undo\" button - undo a move\n"
+"   - \"Undo\" button or Ctrl+Z - undo a move, Ctrl+Y - redo it\n"
 "   - \"Restart\" button - reset the game\n"
 "   - \"Hint\" button - get a hint\n"
 "   - \"Auto Complete\" button - automatically complete the game\n"
@@ -1513,12 +1552,21 @@ StatsState::StatsState() {
     m_currentPage = Page::STATS;
     m_scroll = 0;
     m_maxScroll = 0;
+    m_leadersVersion = 0;
+    m_leadersBuilt = false;
 
     createUI();
 
     m_backSelected = false;
     m_statsTabSelected = true;
     m_achievementsTabSelected = false;
+    m_leadersTabSelected = false;
+}
+
+// Время в виде м:сс
+static std::string formatSeconds(std::int32_t seconds) {
+    std::string secondsPart = std::to_string(seconds % 60);
+    return std::to_string(seconds / 60) + ":" + (secondsPart.size() < 2 ? "0" : "") + secondsPart;
 }
 
 void StatsState::createUI() {
@@ -1537,13 +1585,19 @@ void StatsState::createUI() {
     m_statsTabText.setString("Stats");
     m_statsTabText.setCharacterSize(24);
     m_statsTabText.setFillColor(m_currentPage == Page::STATS ? sf::Color::Yellow : sf::Color::White);
-    m_statsTabText.setPosition(350.0f - m_statsTabText.getLocalBounds().width / 2.0f, 100.0f);
+    m_statsTabText.setPosition(250.0f - m_statsTabText.getLocalBounds().width / 2.0f, 100.0f);
 
     m_achievementsTabText.setFont(font);
     m_achievementsTabText.setString("Achievments");
     m_achievementsTabText.setCharacterSize(24);
     m_achievementsTabText.setFillColor(m_currentPage == Page::ACHIEVEMENTS ? sf::Color::Yellow : sf::Color::White);
-    m_achievementsTabText.setPosition(674.0f - m_achievementsTabText.getLocalBounds().width / 2.0f, 100.0f);
+    m_achievementsTabText.setPosition(512.0f - m_achievementsTabText.getLocalBounds().width / 2.0f, 100.0f);
+
+    m_leadersTabText.setFont(font);
+    m_leadersTabText.setString("Leaders");
+    m_leadersTabText.setCharacterSize(24);
+    m_leadersTabText.setFillColor(m_currentPage == Page::LEADERS ? sf::Color::Yellow : sf::Color::White);
+    m_leadersTabText.setPosition(774.0f - m_leadersTabText.getLocalBounds().width / 2.0f, 100.0f);
 
     // Кнопка назад
     m_backText.setFont(font);
@@ -1565,10 +1619,31 @@ void StatsState::createUI() {
         "Total Moves: " + std::to_string(stats.totalMoves)
     };
 
-    for (int i = 0; i < 6; ++i) {
+    // Тренды по истории партий: запросы идут по столбцам файла, без загрузки в память
+    const GameHistory& history = GameHistory::getInstance();
+    HistoryFilter recent;
+    recent.lastGames = 100;
+    HistorySummary recentSummary = history.summarize(recent);
+    std::uint32_t medianTime = history.medianWinSeconds(recent);
+    std::string trendString;
+    for (const HistorySummary& group : history.trend(recent, 20)) {
+        trendString += " " + std::to_string(static_cast<int>(group.winRate() * 100)) + "%";
+    }
+
+    std::string historyStrings[] = {
+        "Last " + std::to_string(recentSummary.games) + " Games: " + std::to_string(recentSummary.wins) + " Wins (" +
+            std::to_string(static_cast<int>(recentSummary.winRate() * 100)) + "%)",
+        "Median Win Time: " + (medianTime > 0 ? formatSeconds(static_cast<std::int32_t>(medianTime)) : "N/A"),
+        "Win Trend:" + (trendString.empty() ? std::string(" N/A") : trendString)
+    };
+
+    std::vector<std::string> lines(std::begin(statsStrings), std::end(statsStrings));
+    lines.insert(lines.end(), std::begin(historyStrings), std::end(historyStrings));
+
+    for (size_t i = 0; i < lines.size(); ++i) {
         sf::Text statText;
         statText.setFont(font);
-        statText.setString(statsStrings[i]);
+        statText.setString(lines[i]);
         statText.setCharacterSize(24);
         statText.setFillColor(sf::Color::White);
         statText.setPosition(512.0f - statText.getLocalBounds().width / 2.0f, 200.0f + i * 50.0f);
@@ -1617,6 +1692,7 @@ void StatsState::handleEvent(sf::RenderWindow& window, const sf::Event& event, G
         m_backSelected = m_backText.getGlobalBounds().contains(mousePos);
         m_statsTabSelected = m_statsTabText.getGlobalBounds().contains(mousePos);
         m_achievementsTabSelected = m_achievementsTabText.getGlobalBounds().contains(mousePos);
+        m_leadersTabSelected = m_leadersTabText.getGlobalBounds().contains(mousePos);
     }
     else if (event.type == sf::Event::MouseButtonReleased && event.mouseButton.button == sf::Mouse::Left) {
         sf::Vector2f mousePos(event.mouseButton.x, event.mouseButton.y);
@@ -1635,12 +1711,21 @@ void StatsState::handleEvent(sf::RenderWindow& window, const sf::Event& event, G
             m_currentPage = Page::STATS;
             m_statsTabText.setFillColor(sf::Color::Yellow);
             m_achievementsTabText.setFillColor(sf::Color::White);
+            m_leadersTabText.setFillColor(sf::Color::White);
         }
         else if (m_achievementsTabText.getGlobalBounds().contains(mousePos)) {
             // Переключаемся на вкладку достижений
             m_currentPage = Page::ACHIEVEMENTS;
             m_statsTabText.setFillColor(sf::Color::White);
             m_achievementsTabText.setFillColor(sf::Color::Yellow);
+            m_leadersTabText.setFillColor(sf::Color::White);
+        }
+        else if (m_leadersTabText.getGlobalBounds().contains(mousePos)) {
+            // Переключаемся на вкладку рекордов
+            m_currentPage = Page::LEADERS;
+            m_statsTabText.setFillColor(sf::Color::White);
+            m_achievementsTabText.setFillColor(sf::Color::White);
+            m_leadersTabText.setFillColor(sf::Color::Yellow);
         }
     }
     else if (event.type == sf::Event::MouseWheelScrolled) {
@@ -1667,6 +1752,81 @@ void StatsState::update(sf::Time deltaTime, Game& game) {
     m_achievementsTabText.setFillColor(m_currentPage == Page::ACHIEVEMENTS ?
                                      (m_achievementsTabSelected ? sf::Color::Yellow : sf::Color(220, 220, 0)) :
                                      (m_achievementsTabSelected ? sf::Color::Yellow : sf::Color::White));
+    m_leadersTabText.setFillColor(m_currentPage == Page::LEADERS ?
+                                (m_leadersTabSelected ? sf::Color::Yellow : sf::Color(220, 220, 0)) :
+                                (m_leadersTabSelected ? sf::Color::Yellow : sf::Color::White));
+
+    if (m_currentPage == Page::LEADERS) {
+        updateLeaders(game);
+    }
+}
+
+// Пока таблицы рекордов грузятся в фоне, ждём их без событий
+bool StatsState::isAnimating(const Game& game) const {
+    return m_currentPage == Page::LEADERS && !Leaderboard::getInstance().isLoaded();
+}
+
+void StatsState::updateLeaders(Game& game) {
+    const Leaderboard& leaderboard = Leaderboard::getInstance();
+    if (m_leadersBuilt && m_leadersVersion == leaderboard.getVersion()) {
+        return;
+    }
+    m_leadersBuilt = true;
+    m_leadersVersion = leaderboard.getVersion();
+    m_leaderTexts.clear();
+
+    sf::Font& font = ResourceManager::getInstance().getFont();
+    auto addText = [this, &font](const std::string& string, float x, float y, unsigned size, sf::Color color) {
+        sf::Text text;
+        text.setFont(font);
+        text.setString(string);
+        text.setCharacterSize(size);
+        text.setFillColor(color);
+        text.setPosition(x, y);
+        m_leaderTexts.push_back(text);
+    };
+
+    if (!leaderboard.isLoaded()) {
+        addText("Loading...", 450.0f, 200.0f, 24, sf::Color::White);
+        return;
+    }
+
+    const std::uint8_t drawCount = game.captureBoard().drawCount;
+    const LeaderboardMetric metrics[] = {LeaderboardMetric::SCORE, LeaderboardMetric::TIME, LeaderboardMetric::MOVES};
+    const char* titles[] = {"Best Score", "Fastest", "Fewest Moves"};
+    auto valueText = [](LeaderboardMetric metric, const LeaderboardEntry& entry) {
+        return metric == LeaderboardMetric::TIME ? formatSeconds(entry.value) : std::to_string(entry.value);
+    };
+
+    addText("Draw " + std::to_string(drawCount), 100.0f, 150.0f, 20, sf::Color(220, 220, 0));
+    for (int column = 0; column < 3; ++column) {
+        float x = 150.0f + column * 262.0f;
+        addText(titles[column], x, 180.0f, 22, sf::Color::Yellow);
+
+        std::vector<LeaderboardEntry> entries = leaderboard.top(metrics[column], drawCount, 8);
+        for (std::size_t i = 0; i < entries.size(); ++i) {
+            addText(std::to_string(i + 1) + ". " + valueText(metrics[column], entries[i]) + "  #" +
+                        std::to_string(entries[i].dealNumber),
+                    x, 215.0f + i * 30.0f, 18, sf::Color::White);
+        }
+        if (entries.empty()) {
+            addText("No wins yet", x, 215.0f, 18, sf::Color(150, 150, 150));
+        }
+    }
+
+    // Лучшие результаты на текущей раздаче
+    addText("Deal #" + std::to_string(game.getDealNumber()), 100.0f, 480.0f, 20, sf::Color(220, 220, 0));
+    for (int column = 0; column < 3; ++column) {
+        float x = 150.0f + column * 262.0f;
+        std::vector<LeaderboardEntry> entries = leaderboard.topForDeal(metrics[column], drawCount, game.getDealNumber(), 3);
+        for (std::size_t i = 0; i < entries.size(); ++i) {
+            addText(std::to_string(i + 1) + ". " + valueText(metrics[column], entries[i]), x, 515.0f + i * 30.0f, 18,
+                    sf::Color::White);
+        }
+        if (entries.empty()) {
+            addText("-", x, 515.0f, 18, sf::Color(150, 150, 150));
+        }
+    }
 }
 
 void StatsState::render(sf::RenderWindow& window, Game& game) {
@@ -1680,6 +1840,7 @@ void StatsState::render(sf::RenderWindow& window, Game& game) {
     window.draw(m_titleText);
     window.draw(m_statsTabText);
     window.draw(m_achievementsTabText);
+    window.draw(m_leadersTabText);
     window.draw(m_backText);
 
     // Рисуем линию под вкладками
@@ -1716,6 +1877,11 @@ void StatsState::render(sf::RenderWindow& window, Game& game) {
             window.draw(scrollBar);
         }
     }
+    else if (m_currentPage == Page::LEADERS) {
+        for (const auto& text : m_leaderTexts) {
+            window.draw(text);
+        }
+    }
 }
 
 // GameStateManager
@@ -1739,3 +1905,7 @@ void GameStateManager::update(sf::Time deltaTime, Game& game) {
 void GameStateManager::render(sf::RenderWindow& window, Game& game) {
     m_currentState->render(window, game);
 }
+
+bool GameStateManager::isAnimating(const Game& game) const {
+    return m_currentState->isAnimating(game);
+}
@@ -0,0 +1,148 @@
+#include "HintCache.hpp"
+
+static const std::uint32_t TALON_MASK = (1u << STOCK_PILE) | (1u << WASTE_PILE);
+static const std::uint32_t FOUNDATION_MASK = ((1u << TABLEAU_FIRST) - 1) & ~TALON_MASK;
+
+HintCache::HintCache() : m_bestHint(-1), m_recomputedPairs(0) {
+}
+
+void HintCache::reset(const Board& board) {
+    update(board, (1u << PILE_COUNT) - 1);
+}
+
+void HintCache::update(const Board& board, std::uint32_t dirtyMask) {
+    m_board = board;
+    if (dirtyMask & TALON_MASK) {
+        dirtyMask |= TALON_MASK;
+    }
+    if (dirtyMask == 0) {
+        return;
+    }
+
+    bool foundationsChanged = (dirtyMask & FOUNDATION_MASK) != 0;
+    for (int from = WASTE_PILE; from < PILE_COUNT; ++from) {
+        bool fromDirty = (dirtyMask >> from) & 1;
+        for (int to = FOUNDATION_FIRST; to < PILE_COUNT; ++to) {
+            bool toDirty = ((dirtyMask >> to) & 1) || (foundationsChanged && isFoundationPile(to));
+            if (fromDirty || toDirty) {
+                recomputePair(from, to);
+            }
+        }
+    }
+
+    if (dirtyMask & TALON_MASK) {
+        m_stockMove = Move();
+        if (m_board.stockSize() > 0) {
+            m_stockMove.from = STOCK_PILE;
+            m_stockMove.to = WASTE_PILE;
+            m_stockMove.count = static_cast<std::uint8_t>(
+                m_board.stockSize() < m_board.drawCount ? m_board.stockSize() : m_board.drawCount);
+        } else if (m_board.wasteSize > 0) {
+            m_stockMove.from = WASTE_PILE;
+            m_stockMove.to = STOCK_PILE;
+            m_stockMove.count = m_board.wasteSize;
+        }
+    }
+
+    rebuildMoves();
+}
+
+void HintCache::recomputePair(int from, int to) {
+    ++m_recomputedPairs;
+    Move& move = m_pairs[from][to];
+    move = Move();
+    if (from == to) {
+        return;
+    }
+
+    // Карта, которую можно переложить (для игровой стопки - по очереди все открытые)
+    CardId card = NO_CARD;
+    if (from == WASTE_PILE) {
+        card = m_board.wasteTop();
+    } else if (isFoundationPile(from)) {
+        // Из базы только обратно в игровые стопки
+        card = isTableauPile(to) ? m_board.foundation[from - FOUNDATION_FIRST] : NO_CARD;
+    } else if (isFoundationPile(to)) {
+        card = m_board.tableauTop(from - TABLEAU_FIRST);
+    } else {
+        int column = from - TABLEAU_FIRST;
+        int size = m_board.tableauSize[column];
+        for (int start = m_board.faceDown[column]; start < size; ++start) {
+            if (canPlaceOnTableau(m_board, m_board.tableau[column][start], to - TABLEAU_FIRST)) {
+                move.from = static_cast<std::uint8_t>(from);
+                move.to = static_cast<std::uint8_t>(to);
+                move.count = static_cast<std::uint8_t>(size - start);
+                return;
+            }
+        }
+        return;
+    }
+    if (card == NO_CARD) {
+        return;
+    }
+
+    bool legal = isFoundationPile(to) ? findFoundationFor(m_board, card) == to - FOUNDATION_FIRST
+                                      : canPlaceOnTableau(m_board, card, to - TABLEAU_FIRST);
+    if (legal) {
+        move.from = static_cast<std::uint8_t>(from);
+        move.to = static_cast<std::uint8_t>(to);
+        move.count = 1;
+    }
+}
+
+void HintCache::rebuildMoves() {
+    auto addPair = [this](int from, int to) {
+        if (m_pairs[from][to].count > 0) {
+            m_moves.add(m_pairs[from][to]);
+        }
+    };
+
+    // Тот же порядок, что в generateMoves()
+    m_moves.clear();
+    for (int from = WASTE_PILE; from < PILE_COUNT; from = from == WASTE_PILE ? TABLEAU_FIRST : from + 1) {
+        for (int to = FOUNDATION_FIRST; to < TABLEAU_FIRST; ++to) {
+            addPair(from, to);
+        }
+    }
+    for (int to = TABLEAU_FIRST; to < PILE_COUNT; ++to) {
+        addPair(WASTE_PILE, to);
+    }
+    // Между игровыми стопками генератор перебирает открытые карты снизу
+    // вверх, то есть для каждой стопки сначала идут длинные переносы
+    for (int from = TABLEAU_FIRST; from < PILE_COUNT; ++from) {
+        Move sorted[Board::TABLEAU_COUNT];
+        int count = 0;
+        for (int to = TABLEAU_FIRST; to < PILE_COUNT; ++to) {
+            const Move& move = m_pairs[from][to];
+            if (move.count == 0) {
+                continue;
+            }
+            int i = count++;
+            for (; i > 0 && sorted[i - 1].count < move.count; --i) {
+                sorted[i] = sorted[i - 1];
+            }
+            sorted[i] = move;
+        }
+        for (int i = 0; i < count; ++i) {
+            m_moves.add(sorted[i]);
+        }
+    }
+    for (int from = FOUNDATION_FIRST; from < TABLEAU_FIRST; ++from) {
+        for (int to = TABLEAU_FIRST; to < PILE_COUNT; ++to) {
+            addPair(from, to);
+        }
+    }
+    if (m_stockMove.count > 0) {
+        m_moves.add(m_stockMove);
+    }
+
+    m_bestHint = -1;
+    int bestPriority = 0;
+    for (int i = 0; i < m_moves.size(); ++i) {
+        int priority = hintPriority(m_board, m_moves[i]);
+        if (priority > bestPriority) {
+            bestPriority = priority;
+            m_bestHint = i;
+        }
+    }
+}
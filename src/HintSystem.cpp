@@ -7,64 +7,38 @@ HintSystem::HintSystem(Game& game) : m_game(game) {}
 std::vector<Hint> HintSystem::getHints() {
     std::vector<Hint> hints;
 
-    // Проверяем возможность перемещения карт из всех стопок
-    for (size_t sourceIndex = 0; sourceIndex < m_game.getPileCount(); ++sourceIndex) {
-        auto sourcePile = m_game.getPile(sourceIndex);
-
-        // Пропускаем пустые стопки и стопки foundation
-        if (sourcePile->isEmpty() || sourcePile->getType() == PileType::FOUNDATION) {
+    for (const Move& move : m_game.getHintCache().getMoves()) {
+        // Переворот сброса и возврат карт из баз подсказками не считаем
+        if (move.isRecycle() || isFoundationPile(move.from)) {
             continue;
         }
-
-        // Проверяем верхнюю карту для стопок stock и waste
-        if (sourcePile->getType() == PileType::STOCK || sourcePile->getType() == PileType::WASTE) {
-            auto card = sourcePile->getTopCard();
-            if (card && card->isFaceUp()) {
-                addCardHints(hints, card, sourcePile);
-            }
-        }
-        // Для tableau проверяем все открытые карты
-        else if (sourcePile->getType() == PileType::TABLEAU) {
-            for (size_t i = 0; i < sourcePile->getCardCount(); ++i) {
-                auto card = sourcePile->getCardAt(i);
-                if (card && card->isFaceUp()) {
-                    addCardHints(hints, card, sourcePile);
-                }
-            }
-        }
-    }
-
-    // Проверяем колоду, если она не пуста
-    auto stockPile = m_game.getStockPile();
-    if (!stockPile->isEmpty()) {
-        // Добавляем подсказку о возможности взять карту из колоды
-        Hint hint;
-        hint.card = stockPile->getTopCard();
-        hint.sourcePile = stockPile;
-        hint.targetPile = m_game.getWastePile();
-        hints.push_back(hint);
+        hints.push_back(makeHint(move));
     }
 
     return hints;
 }
 
 Hint HintSystem::getBestHint() {
-    auto hints = getHints();
-
-    // Ищем подсказку с перемещением в foundation
-    for (const auto& hint : hints) {
-        if (hint.targetPile->getType() == PileType::FOUNDATION) {
-            return hint;
+    const HintCache& cache = m_game.getHintCache();
+    const Board& board = cache.getBoard();
+    const MoveList& moves = cache.getMoves();
+
+    // Тот же выбор, что и в Game::useHint(): первый ход с наибольшим приоритетом
+    const Move* bestMove = nullptr;
+    int bestPriority = -1;
+    for (const Move& move : moves) {
+        int priority = hintPriority(board, move);
+        if (priority > bestPriority) {
+            bestPriority = priority;
+            bestMove = &move;
         }
     }
 
-    // Если нет подсказок с перемещением в foundation, возвращаем первую доступную
-    if (!hints.empty()) {
-        return hints[0];
-    }
-
     // Если подсказок нет, возвращаем пустую подсказку
-    return Hint();
+    if (!bestMove) {
+        return Hint();
+    }
+    return makeHint(*bestMove);
 }
 
 void HintSystem::highlightHint(const Hint& hint) {
@@ -82,35 +56,16 @@ void HintSystem::highlightHint(const Hint& hint) {
     }
 }
 
-void HintSystem::addCardHints(std::vector<Hint>& hints, std::shared_ptr<Card> card, std::shared_ptr<Pile> sourcePile) {
-    // Проверяем возможность перемещения в foundation
-    for (size_t i = 0; i < m_game.getFoundationPilesCount(); ++i) {
-        auto targetPile = m_game.getFoundationPile(i);
-        if (targetPile->canAddCard(card)) {
-            Hint hint;
-            hint.card = card;
-            hint.sourcePile = sourcePile;
-            hint.targetPile = targetPile;
-            hints.push_back(hint);
-        }
-    }
-
-    // Проверяем возможность перемещения в tableau
-    for (size_t i = 0; i < m_game.getTableauPilesCount(); ++i) {
-        auto targetPile = m_game.getTableauPile(i);
-        // Пропускаем перемещение в ту же стопку
-        if (targetPile == sourcePile) {
-            continue;
-        }
-
-        if (targetPile->canAddCard(card)) {
-            Hint hint;
-            hint.card = card;
-            hint.sourcePile = sourcePile;
-            hint.targetPile = targetPile;
-            hints.push_back(hint);
-        }
+Hint HintSystem::makeHint(const Move& move) const {
+    Hint hint;
+    hint.sourcePile = m_game.getPile(move.from);
+    hint.targetPile = m_game.getPile(move.to);
+    if (hint.sourcePile && hint.sourcePile->getCardCount() >= move.count) {
+        // Для взятия из колоды - верхняя карта, иначе нижняя из перемещаемых
+        hint.card = move.isDraw() ? hint.sourcePile->getTopCard()
+                                  : hint.sourcePile->getCardAt(hint.sourcePile->getCardCount() - move.count);
     }
+    return hint;
 }
 
 std::vector<Pile*> HintSystem::findPossibleMoves(const Card* card) const {
@@ -120,19 +75,25 @@ std::vector<Pile*> HintSystem::findPossibleMoves(const Card* card) const {
         return possibleMoves;
     }
 
-    // Проверяем все стопки foundation из Game
-    for (size_t i = 0; i < m_game.getFoundationPilesCount(); ++i) {
-        auto targetPile = m_game.getFoundationPile(i);
-        if (targetPile->canAcceptCard(card)) {
-            possibleMoves.push_back(targetPile.get());
+    // Сколько карт уходит вместе с этой (она сама и все над ней)
+    const Pile* sourcePile = card->getPile();
+    int source = m_game.getPileIndex(sourcePile);
+    const auto& cards = sourcePile->getCards();
+    int count = 0;
+    for (size_t i = 0; i < cards.size(); ++i) {
+        if (cards[i].get() == card) {
+            count = static_cast<int>(cards.size() - i);
+            break;
         }
     }
+    if (source < 0 || count == 0) {
+        return possibleMoves;
+    }
 
-    // Проверяем все стопки tableau из Game
-    for (size_t i = 0; i < m_game.getTableauPilesCount(); ++i) {
-        auto targetPile = m_game.getTableauPile(i);
-        if (targetPile.get() != card->getPile() && targetPile->canAcceptCard(card)) {
-            possibleMoves.push_back(targetPile.get());
+    // Ходы в базы перечисляются раньше ходов в игровые стопки
+    for (const Move& move : m_game.getHintCache().getMoves()) {
+        if (move.from == source && move.count == count && !move.isDraw() && !move.isRecycle()) {
+            possibleMoves.push_back(m_game.getPile(move.to).get());
         }
     }
 
@@ -0,0 +1,42 @@
+#include "HudLabel.hpp"
+
+unsigned HudLabel::s_frameRebuilds = 0;
+std::uint64_t HudLabel::s_totalRebuilds = 0;
+
+HudLabel::HudLabel()
+    : m_normalColor(sf::Color::White), m_highlightedColor(sf::Color::Yellow), m_highlighted(false), m_value(0),
+      m_hasValue(false) {
+}
+
+void HudLabel::init(const sf::Font& font, const std::string& string, unsigned characterSize,
+                    const sf::Vector2f& position) {
+    m_text.setFont(font);
+    m_text.setString(string);
+    m_text.setCharacterSize(characterSize);
+    m_text.setFillColor(m_highlighted ? m_highlightedColor : m_normalColor);
+    m_text.setPosition(position);
+}
+
+void HudLabel::setColors(const sf::Color& normal, const sf::Color& highlighted) {
+    m_normalColor = normal;
+    m_highlightedColor = highlighted;
+    m_text.setFillColor(m_highlighted ? m_highlightedColor : m_normalColor);
+}
+
+void HudLabel::setHighlighted(bool highlighted) {
+    if (highlighted == m_highlighted) {
+        return;
+    }
+    m_highlighted = highlighted;
+    m_text.setFillColor(m_highlighted ? m_highlightedColor : m_normalColor);
+}
+
+void HudLabel::reshape(const std::string& string) {
+    m_text.setString(string);
+    ++s_frameRebuilds;
+    ++s_totalRebuilds;
+}
+
+void HudLabel::draw(sf::RenderTarget& target, sf::RenderStates states) const {
+    target.draw(m_text, states);
+}
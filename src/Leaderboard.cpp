@@ -0,0 +1,300 @@
+#include "Leaderboard.hpp"
+#include "BinaryIO.hpp"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <system_error>
+
+static const char MAGIC[4] = {'K', 'L', 'D', 'B'};
+static const std::uint32_t VERSION = 1;
+static const std::size_t HEADER_SIZE = 8;
+static const std::size_t RECORD_SIZE = 28;
+
+const char* const Leaderboard::DEFAULT_PATH = "leaderboard.db";
+
+static void encodeRecord(const HistoryRecord& record, unsigned char* out) {
+    out[0] = record.drawCount;
+    out[1] = 0;
+    writeU16(out + 2, record.moves);
+    writeU32(out + 4, record.dealNumber);
+    writeU32(out + 8, static_cast<std::uint32_t>(record.score));
+    writeU32(out + 12, record.seconds);
+    writeU64(out + 16, static_cast<std::uint64_t>(record.timestamp));
+    writeU32(out + 24, crc32(out, 24));
+}
+
+static HistoryRecord decodeRecord(const unsigned char* in) {
+    HistoryRecord record;
+    record.drawCount = in[0];
+    record.won = true;
+    record.moves = readU16(in + 2);
+    record.dealNumber = readU32(in + 4);
+    record.score = static_cast<std::int32_t>(readU32(in + 8));
+    record.seconds = readU32(in + 12);
+    record.timestamp = static_cast<std::int64_t>(readU64(in + 16));
+    return record;
+}
+
+static int variantIndex(std::uint8_t drawCount) {
+    return drawCount == 1 ? 0 : (drawCount == 3 ? 1 : -1);
+}
+
+static std::uint64_t dealKey(std::uint8_t drawCount, std::uint32_t dealNumber) {
+    return (static_cast<std::uint64_t>(drawCount) << 32) | dealNumber;
+}
+
+static std::int32_t metricValue(const HistoryRecord& record, int metric) {
+    switch (static_cast<LeaderboardMetric>(metric)) {
+    case LeaderboardMetric::SCORE:
+        return record.score;
+    case LeaderboardMetric::TIME:
+        return static_cast<std::int32_t>(std::min<std::uint32_t>(record.seconds, 0x7FFFFFFF));
+    case LeaderboardMetric::MOVES:
+        return record.moves;
+    }
+    return 0;
+}
+
+// Порядок таблицы: лучший результат первым, при равенстве - более ранний
+struct Better {
+    LeaderboardMetric metric;
+
+    bool operator()(const LeaderboardEntry& a, const LeaderboardEntry& b) const {
+        if (a.value != b.value) {
+            return metric == LeaderboardMetric::SCORE ? a.value > b.value : a.value < b.value;
+        }
+        return a.timestamp < b.timestamp;
+    }
+};
+
+Leaderboard& Leaderboard::getInstance() {
+    static Leaderboard instance;
+    static bool triedOpen = false;
+    if (!triedOpen) {
+        triedOpen = true;
+        instance.open(DEFAULT_PATH);
+    }
+    return instance;
+}
+
+Leaderboard::Leaderboard() : m_version(0), m_loaded(false), m_stopping(false) {
+}
+
+Leaderboard::~Leaderboard() {
+    close();
+}
+
+bool Leaderboard::open(const std::string& path) {
+    close();
+    m_path = path;
+    m_stopping = false;
+    m_loaded = false;
+    try {
+        m_thread = std::thread(&Leaderboard::workerLoop, this);
+    } catch (const std::system_error&) {
+        return false;
+    }
+    return true;
+}
+
+void Leaderboard::close() {
+    if (!m_thread.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        m_stopping = true;
+    }
+    m_wake.notify_one();
+    m_thread.join();
+}
+
+void Leaderboard::submit(const HistoryRecord& record) {
+    if (!record.won || variantIndex(record.drawCount) < 0 || !m_thread.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        m_queue.push_back(record);
+    }
+    m_wake.notify_one();
+}
+
+void Leaderboard::workerLoop() {
+    // Загрузка: все записи до первой битой, таблицы сортируются один раз
+    std::vector<unsigned char> bytes;
+    {
+        std::ifstream in(m_path, std::ios::binary);
+        if (in) {
+            bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        }
+    }
+    bool validHeader = bytes.size() >= HEADER_SIZE && std::memcmp(bytes.data(), MAGIC, sizeof(MAGIC)) == 0 &&
+                       readU32(bytes.data() + 4) == VERSION;
+    std::size_t validSize = HEADER_SIZE;
+    Tables variants[2];
+    std::unordered_map<std::uint64_t, Tables> deals;
+    if (validHeader) {
+        for (; validSize + RECORD_SIZE <= bytes.size(); validSize += RECORD_SIZE) {
+            const unsigned char* in = bytes.data() + validSize;
+            if (crc32(in, 24) != readU32(in + 24) || variantIndex(in[0]) < 0) {
+                break;
+            }
+            HistoryRecord record = decodeRecord(in);
+            Tables& dealTables = deals[dealKey(record.drawCount, record.dealNumber)];
+            for (int metric = 0; metric < METRIC_COUNT; ++metric) {
+                LeaderboardEntry entry;
+                entry.value = metricValue(record, metric);
+                entry.dealNumber = record.dealNumber;
+                entry.timestamp = record.timestamp;
+                variants[variantIndex(record.drawCount)].byMetric[metric].push_back(entry);
+                dealTables.byMetric[metric].push_back(entry);
+            }
+        }
+    }
+    auto sortTables = [](Tables& tables) {
+        for (int metric = 0; metric < METRIC_COUNT; ++metric) {
+            std::vector<LeaderboardEntry>& entries = tables.byMetric[metric];
+            std::sort(entries.begin(), entries.end(), Better{static_cast<LeaderboardMetric>(metric)});
+        }
+    };
+    for (Tables& tables : variants) {
+        sortTables(tables);
+    }
+    for (auto& deal : deals) {
+        sortTables(deal.second);
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (int i = 0; i < 2; ++i) {
+            m_variants[i] = std::move(variants[i]);
+        }
+        m_deals = std::move(deals);
+    }
+    m_loaded = true;
+    ++m_version;
+
+    // Битый или оборванный хвост отрезается, иначе новые записи легли бы за ним
+    std::FILE* file = nullptr;
+    if (validHeader) {
+        std::error_code error;
+        if (validSize != bytes.size()) {
+            std::filesystem::resize_file(m_path, validSize, error);
+        }
+        if (!error) {
+            file = std::fopen(m_path.c_str(), "ab");
+        }
+    } else {
+        unsigned char header[HEADER_SIZE];
+        std::memcpy(header, MAGIC, sizeof(MAGIC));
+        writeU32(header + 4, VERSION);
+        if (writeFileAtomic(m_path, header, sizeof(header))) {
+            file = std::fopen(m_path.c_str(), "ab");
+        }
+    }
+
+    std::unique_lock<std::mutex> lock(m_queueMutex);
+    while (true) {
+        m_wake.wait(lock, [this] { return m_stopping || !m_queue.empty(); });
+        std::deque<HistoryRecord> batch;
+        batch.swap(m_queue);
+        bool stopping = m_stopping;
+        lock.unlock();
+
+        for (const HistoryRecord& record : batch) {
+            if (file) {
+                unsigned char out[RECORD_SIZE];
+                encodeRecord(record, out);
+                std::fwrite(out, 1, sizeof(out), file);
+            }
+            insert(record);
+        }
+        if (!batch.empty()) {
+            if (file) {
+                syncFile(file);
+            }
+            ++m_version;
+        }
+
+        lock.lock();
+        if (stopping && m_queue.empty()) {
+            break;
+        }
+    }
+    lock.unlock();
+    if (file) {
+        std::fclose(file);
+    }
+}
+
+void Leaderboard::insert(const HistoryRecord& record) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Tables& variant = m_variants[variantIndex(record.drawCount)];
+    Tables& deal = m_deals[dealKey(record.drawCount, record.dealNumber)];
+    for (int metric = 0; metric < METRIC_COUNT; ++metric) {
+        LeaderboardEntry entry;
+        entry.value = metricValue(record, metric);
+        entry.dealNumber = record.dealNumber;
+        entry.timestamp = record.timestamp;
+        Better better{static_cast<LeaderboardMetric>(metric)};
+        for (std::vector<LeaderboardEntry>* entries : {&variant.byMetric[metric], &deal.byMetric[metric]}) {
+            entries->insert(std::upper_bound(entries->begin(), entries->end(), entry, better), entry);
+        }
+    }
+}
+
+const Leaderboard::Tables* Leaderboard::findTables(std::uint8_t drawCount) const {
+    int index = variantIndex(drawCount);
+    return index < 0 ? nullptr : &m_variants[index];
+}
+
+const Leaderboard::Tables* Leaderboard::findDealTables(std::uint8_t drawCount, std::uint32_t dealNumber) const {
+    auto it = m_deals.find(dealKey(drawCount, dealNumber));
+    return it == m_deals.end() ? nullptr : &it->second;
+}
+
+static std::vector<LeaderboardEntry> firstEntries(const std::vector<LeaderboardEntry>& entries, std::size_t count) {
+    return std::vector<LeaderboardEntry>(entries.begin(), entries.begin() + std::min(count, entries.size()));
+}
+
+std::vector<LeaderboardEntry> Leaderboard::top(LeaderboardMetric metric, std::uint8_t drawCount,
+                                               std::size_t count) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const Tables* tables = findTables(drawCount);
+    if (!tables) {
+        return {};
+    }
+    return firstEntries(tables->byMetric[static_cast<int>(metric)], count);
+}
+
+std::vector<LeaderboardEntry> Leaderboard::topForDeal(LeaderboardMetric metric, std::uint8_t drawCount,
+                                                      std::uint32_t dealNumber, std::size_t count) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const Tables* tables = findDealTables(drawCount, dealNumber);
+    if (!tables) {
+        return {};
+    }
+    return firstEntries(tables->byMetric[static_cast<int>(metric)], count);
+}
+
+std::size_t Leaderboard::rank(LeaderboardMetric metric, std::uint8_t drawCount, std::int32_t value) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const Tables* tables = findTables(drawCount);
+    if (!tables) {
+        return 1;
+    }
+    // Выше стоят только строго лучшие результаты
+    const std::vector<LeaderboardEntry>& entries = tables->byMetric[static_cast<int>(metric)];
+    auto place = std::partition_point(entries.begin(), entries.end(), [metric, value](const LeaderboardEntry& entry) {
+        return metric == LeaderboardMetric::SCORE ? entry.value > value : entry.value < value;
+    });
+    return static_cast<std::size_t>(place - entries.begin()) + 1;
+}
+
+std::size_t Leaderboard::size(LeaderboardMetric metric, std::uint8_t drawCount) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const Tables* tables = findTables(drawCount);
+    return tables ? tables->byMetric[static_cast<int>(metric)].size() : 0;
+}
@@ -0,0 +1,321 @@
+#include "MoveGenerator.hpp"
+
+bool canPlaceOnTableau(const Board& board, CardId card, int column) {
+    if (board.tableauSize[column] == 0) {
+        return cardRank(card) == 13;
+    }
+    CardId top = board.tableauTop(column);
+    return cardIsRed(card) != cardIsRed(top) && cardRank(card) == cardRank(top) - 1;
+}
+
+int findFoundationFor(const Board& board, CardId card) {
+    // Туз кладём в первую пустую базу, как Game::findFoundationForAce()
+    if (cardRank(card) == 1) {
+        for (int i = 0; i < Board::FOUNDATION_COUNT; ++i) {
+            if (board.foundation[i] == NO_CARD) {
+                return i;
+            }
+        }
+        return -1;
+    }
+    // Под картой той же масти лежит идентификатор на единицу меньше
+    for (int i = 0; i < Board::FOUNDATION_COUNT; ++i) {
+        if (board.foundation[i] == card - 1) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+int generateMoves(const Board& board, Move* moves, int capacity) {
+    int count = 0;
+    auto add = [moves, capacity, &count](int from, int to, int cards) {
+        if (count < capacity) {
+            Move& move = moves[count++];
+            move.from = static_cast<std::uint8_t>(from);
+            move.to = static_cast<std::uint8_t>(to);
+            move.count = static_cast<std::uint8_t>(cards);
+            move.flags = 0;
+        }
+    };
+
+    CardId wasteTop = board.wasteTop();
+
+    // 1. В базы: верхняя карта сброса и верхние карты игровых стопок
+    if (wasteTop != NO_CARD) {
+        int foundation = findFoundationFor(board, wasteTop);
+        if (foundation >= 0) {
+            add(WASTE_PILE, FOUNDATION_FIRST + foundation, 1);
+        }
+    }
+    for (int column = 0; column < Board::TABLEAU_COUNT; ++column) {
+        CardId top = board.tableauTop(column);
+        if (top != NO_CARD) {
+            int foundation = findFoundationFor(board, top);
+            if (foundation >= 0) {
+                add(TABLEAU_FIRST + column, FOUNDATION_FIRST + foundation, 1);
+            }
+        }
+    }
+
+    // 2. Из сброса в игровые стопки
+    if (wasteTop != NO_CARD) {
+        for (int column = 0; column < Board::TABLEAU_COUNT; ++column) {
+            if (canPlaceOnTableau(board, wasteTop, column)) {
+                add(WASTE_PILE, TABLEAU_FIRST + column, 1);
+            }
+        }
+    }
+
+    // 3. Между игровыми стопками: любая открытая карта вместе с картами над ней
+    for (int source = 0; source < Board::TABLEAU_COUNT; ++source) {
+        int size = board.tableauSize[source];
+        for (int start = board.faceDown[source]; start < size; ++start) {
+            CardId card = board.tableau[source][start];
+            for (int target = 0; target < Board::TABLEAU_COUNT; ++target) {
+                if (target != source && canPlaceOnTableau(board, card, target)) {
+                    add(TABLEAU_FIRST + source, TABLEAU_FIRST + target, size - start);
+                }
+            }
+        }
+    }
+
+    // 4. Из баз обратно в игровые стопки
+    for (int i = 0; i < Board::FOUNDATION_COUNT; ++i) {
+        CardId top = board.foundation[i];
+        if (top == NO_CARD) {
+            continue;
+        }
+        for (int column = 0; column < Board::TABLEAU_COUNT; ++column) {
+            if (canPlaceOnTableau(board, top, column)) {
+                add(FOUNDATION_FIRST + i, TABLEAU_FIRST + column, 1);
+            }
+        }
+    }
+
+    // 5. Колода: взять карты или перевернуть сброс
+    if (board.stockSize() > 0) {
+        int drawn = board.stockSize() < board.drawCount ? board.stockSize() : board.drawCount;
+        add(STOCK_PILE, WASTE_PILE, drawn);
+    } else if (board.wasteSize > 0) {
+        add(WASTE_PILE, STOCK_PILE, board.wasteSize);
+    }
+
+    return count;
+}
+
+// Снимает верхнюю карту сброса, сдвигая оставшуюся колоду
+static CardId takeWasteTop(Board& board) {
+    int index = board.wasteSize - 1;
+    CardId card = board.talon[index];
+    for (int i = index; i + 1 < board.talonSize; ++i) {
+        board.talon[i] = board.talon[i + 1];
+    }
+    board.talon[--board.talonSize] = NO_CARD;
+    --board.wasteSize;
+    return card;
+}
+
+// Возвращает карту на верх сброса (обратная операция к takeWasteTop)
+static void putWasteTop(Board& board, CardId card) {
+    for (int i = board.talonSize; i > board.wasteSize; --i) {
+        board.talon[i] = board.talon[i - 1];
+    }
+    board.talon[board.wasteSize++] = card;
+    ++board.talonSize;
+}
+
+// Снимает верхнюю карту базы: под ней лежит карта той же масти на ранг ниже
+static CardId takeFoundationTop(Board& board, int index) {
+    CardId card = board.foundation[index];
+    board.foundation[index] = cardRank(card) > 1 ? static_cast<CardId>(card - 1) : NO_CARD;
+    return card;
+}
+
+// Забирает count верхних карт игровой стопки и открывает новую верхнюю
+static void takeFromTableau(Board& board, int column, int count, CardId* cards, Move& move) {
+    int start = board.tableauSize[column] - count;
+    for (int i = 0; i < count; ++i) {
+        cards[i] = board.tableau[column][start + i];
+        board.tableau[column][start + i] = NO_CARD;
+    }
+    board.tableauSize[column] = static_cast<std::uint8_t>(start);
+    if (start > 0 && board.faceDown[column] == start) {
+        --board.faceDown[column];
+        move.flags |= Move::FLIPPED;
+    }
+}
+
+static void pushToTableau(Board& board, int column, const CardId* cards, int count) {
+    for (int i = 0; i < count; ++i) {
+        board.tableau[column][board.tableauSize[column]++] = cards[i];
+    }
+}
+
+void applyMove(Board& board, Move& move) {
+    move.flags = 0;
+
+    if (move.isDraw()) {
+        board.wasteSize = static_cast<std::uint8_t>(board.wasteSize + move.count);
+        return;
+    }
+    if (move.isRecycle()) {
+        board.wasteSize = 0;
+        return;
+    }
+
+    // Снимаем карты с исходной стопки
+    CardId cards[Board::TABLEAU_CAPACITY];
+    int count = move.count;
+    if (move.from == WASTE_PILE) {
+        cards[0] = takeWasteTop(board);
+    } else if (isFoundationPile(move.from)) {
+        cards[0] = takeFoundationTop(board, move.from - FOUNDATION_FIRST);
+    } else {
+        takeFromTableau(board, move.from - TABLEAU_FIRST, count, cards, move);
+    }
+
+    // Кладём их на целевую
+    if (isFoundationPile(move.to)) {
+        board.foundation[move.to - FOUNDATION_FIRST] = cards[0];
+    } else {
+        pushToTableau(board, move.to - TABLEAU_FIRST, cards, count);
+    }
+}
+
+void undoMove(Board& board, const Move& move) {
+    if (move.isDraw()) {
+        board.wasteSize = static_cast<std::uint8_t>(board.wasteSize - move.count);
+        return;
+    }
+    if (move.isRecycle()) {
+        board.wasteSize = move.count;
+        return;
+    }
+
+    // Снимаем карты с целевой стопки
+    CardId cards[Board::TABLEAU_CAPACITY];
+    int count = move.count;
+    if (isFoundationPile(move.to)) {
+        cards[0] = takeFoundationTop(board, move.to - FOUNDATION_FIRST);
+    } else {
+        int column = move.to - TABLEAU_FIRST;
+        int start = board.tableauSize[column] - count;
+        for (int i = 0; i < count; ++i) {
+            cards[i] = board.tableau[column][start + i];
+            board.tableau[column][start + i] = NO_CARD;
+        }
+        board.tableauSize[column] = static_cast<std::uint8_t>(start);
+    }
+
+    // Возвращаем в исходную
+    if (move.from == WASTE_PILE) {
+        putWasteTop(board, cards[0]);
+    } else if (isFoundationPile(move.from)) {
+        board.foundation[move.from - FOUNDATION_FIRST] = cards[0];
+    } else {
+        int column = move.from - TABLEAU_FIRST;
+        if (move.flipped()) {
+            ++board.faceDown[column];
+        }
+        pushToTableau(board, column, cards, count);
+    }
+}
+
+bool isLegalMove(const Board& board, const Move& move) {
+    MoveList moves;
+    moves.generate(board);
+    for (const Move& legal : moves) {
+        if (legal == move) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Хватает ли карт в целевой стопке и места в исходной, чтобы undoMove()
+// не вышел за пределы массивов
+static bool fitsUndo(const Board& board, const Move& move) {
+    if (move.isDraw()) {
+        return board.wasteSize >= move.count;
+    }
+    if (move.isRecycle()) {
+        return board.wasteSize == 0 && board.talonSize >= move.count;
+    }
+    bool fromOk = move.from == WASTE_PILE || isFoundationPile(move.from) || isTableauPile(move.from);
+    bool toOk = isFoundationPile(move.to) || isTableauPile(move.to);
+    if (!fromOk || !toOk || (move.count != 1 && !(isTableauPile(move.from) && isTableauPile(move.to)))) {
+        return false;
+    }
+    if (board.pileSize(move.to) < move.count) {
+        return false;
+    }
+    if (move.from == WASTE_PILE) {
+        return board.talonSize < Board::TALON_CAPACITY;
+    }
+    if (isTableauPile(move.from)) {
+        return board.tableauSize[move.from - TABLEAU_FIRST] + move.count <= Board::TABLEAU_CAPACITY;
+    }
+    return true;
+}
+
+bool undoMoveChecked(Board& board, const Move& move) {
+    if (!fitsUndo(board, move)) {
+        return false;
+    }
+    Board previous = board;
+    undoMove(previous, move);
+    if (!previous.isValid() || !isLegalMove(previous, move)) {
+        return false;
+    }
+
+    // Ход из предыдущей позиции должен привести ровно в текущую
+    Board check = previous;
+    Move applied = move;
+    applyMove(check, applied);
+    if (check != board || applied.flags != move.flags) {
+        return false;
+    }
+    board = previous;
+    return true;
+}
+
+int hintPriority(const Board& board, const Move& move) {
+    if (move.isDraw() || move.isRecycle()) {
+        return 0;
+    }
+    if (isFoundationPile(move.from)) {
+        return -1;
+    }
+
+    // Карта, которая перемещается первой (нижняя в группе)
+    CardId card;
+    if (move.from == WASTE_PILE) {
+        card = board.wasteTop();
+    } else {
+        int column = move.from - TABLEAU_FIRST;
+        card = board.tableau[column][board.tableauSize[column] - move.count];
+    }
+
+    if (isFoundationPile(move.to)) {
+        return cardRank(card) == 1 ? 5 : 4;
+    }
+
+    bool toEmpty = board.tableauSize[move.to - TABLEAU_FIRST] == 0;
+    if (move.from == WASTE_PILE) {
+        return toEmpty ? 3 : 2;
+    }
+
+    // Между игровыми стопками: важно, откроется ли закрытая карта
+    int column = move.from - TABLEAU_FIRST;
+    int start = board.tableauSize[column] - move.count;
+    bool revealsCard = start > 0 && start == board.faceDown[column];
+    if (toEmpty) {
+        // Король, который и так лежит на пустом месте, переносить незачем
+        if (start == 0) {
+            return -1;
+        }
+        return revealsCard ? 4 : 2;
+    }
+    return revealsCard ? 3 : 1;
+}
@@ -0,0 +1,247 @@
+#include "ParallelSolver.hpp"
+#include "Zobrist.hpp"
+#include <thread>
+
+ParallelSolver::ParallelSolver(const SolverLimits& limits, int threadCount)
+    : m_limits(limits),
+      m_threadCount(threadCount),
+      m_table(limits.tableBytes, limits.replacement),
+      m_tableUsed(false),
+      m_stop(false),
+      m_cancelled(false),
+      m_aborted(false),
+      m_depthLimited(false),
+      m_found(false),
+      m_idle(0),
+      m_pending(0),
+      m_nodes(0) {
+    if (m_threadCount <= 0) {
+        m_threadCount = static_cast<int>(std::thread::hardware_concurrency());
+        if (m_threadCount <= 0) {
+            m_threadCount = 1;
+        }
+    }
+}
+
+ParallelSolution ParallelSolver::solve(const Board& board) {
+    m_stop = false;
+    m_cancelled = false;
+    m_aborted = false;
+    m_depthLimited = false;
+    m_found = false;
+    m_idle = 0;
+    m_pending = 0;
+    m_nodes = 0;
+    m_solution.clear();
+    m_startTime = std::chrono::steady_clock::now();
+
+    m_queues.clear();
+    for (int i = 0; i < m_threadCount; ++i) {
+        m_queues.push_back(std::make_unique<WorkQueue>());
+    }
+    if (m_tableUsed) {
+        m_table.clear();
+    }
+    m_tableUsed = true;
+
+    Task root;
+    root.board = board;
+    root.hash = zobristHash(board);
+    pushTask(0, std::move(root));
+
+    // Вызывающий поток работает как поток 0
+    std::vector<Worker> workers(m_threadCount);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < m_threadCount; ++i) {
+        workers[i].index = i;
+    }
+    for (int i = 1; i < m_threadCount; ++i) {
+        threads.emplace_back([this, &workers, i]() { run(workers[i]); });
+    }
+    run(workers[0]);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    ParallelSolution solution;
+    if (m_found) {
+        solution.result = SolveResult::WINNABLE;
+        solution.moves = m_solution;
+    } else if (m_aborted || m_cancelled || m_depthLimited) {
+        solution.result = SolveResult::UNKNOWN;
+    } else {
+        solution.result = SolveResult::UNWINNABLE;
+    }
+    solution.nodes = m_nodes;
+    solution.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - m_startTime).count();
+    for (const auto& worker : workers) {
+        solution.threads.push_back(worker.stats);
+    }
+
+    solution.table = m_table.getStats();
+
+    m_queues.clear();
+    return solution;
+}
+
+void ParallelSolver::run(Worker& worker) {
+    auto start = std::chrono::steady_clock::now();
+    Task task;
+    bool idle = false;
+    int failedAttempts = 0;
+
+    while (!m_stop) {
+        if (takeTask(worker, task)) {
+            if (idle) {
+                --m_idle;
+                idle = false;
+            }
+            failedAttempts = 0;
+            ++worker.stats.tasks;
+
+            worker.path = std::move(task.path);
+            if (search(worker, task.board, task.hash, task.depth)) {
+                reportWin(worker.path);
+            }
+            --m_pending;
+            continue;
+        }
+
+        if (!idle) {
+            ++m_idle;
+            idle = true;
+        }
+        // Работы нет ни в очередях, ни у других потоков - перебор закончен
+        if (m_pending == 0) {
+            break;
+        }
+        if (++failedAttempts < 64) {
+            std::this_thread::yield();
+        } else {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    }
+
+    if (idle) {
+        --m_idle;
+    }
+    flushNodes(worker);
+    worker.stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+bool ParallelSolver::takeTask(Worker& worker, Task& task) {
+    // Свою очередь берём с конца (глубже и свежее)
+    {
+        WorkQueue& own = *m_queues[worker.index];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            --own.size;
+            return true;
+        }
+    }
+
+    // У других крадём с начала: там ветви ближе к корню
+    for (int offset = 1; offset < m_threadCount; ++offset) {
+        WorkQueue& victim = *m_queues[(worker.index + offset) % m_threadCount];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            --victim.size;
+            ++worker.stats.steals;
+            return true;
+        }
+    }
+    return false;
+}
+
+void ParallelSolver::pushTask(int queue, Task&& task) {
+    ++m_pending;
+    WorkQueue& target = *m_queues[queue];
+    std::lock_guard<std::mutex> lock(target.mutex);
+    target.tasks.push_back(std::move(task));
+    ++target.size;
+}
+
+void ParallelSolver::flushNodes(Worker& worker) {
+    std::uint64_t total = m_nodes.fetch_add(worker.pendingNodes) + worker.pendingNodes;
+    worker.pendingNodes = 0;
+
+    bool overNodes = m_limits.maxNodes && total >= m_limits.maxNodes;
+    bool overTime = m_limits.maxSeconds > 0.0 &&
+                    std::chrono::duration<double>(std::chrono::steady_clock::now() - m_startTime).count() >=
+                        m_limits.maxSeconds;
+    if (overNodes || overTime) {
+        m_aborted = true;
+        m_stop = true;
+    }
+}
+
+void ParallelSolver::reportWin(const std::vector<Move>& path) {
+    std::lock_guard<std::mutex> lock(m_solutionMutex);
+    if (!m_found) {
+        m_found = true;
+        m_solution = path;
+    }
+    m_stop = true;
+}
+
+bool ParallelSolver::search(Worker& worker, const Board& position, std::uint64_t hash, int depth) {
+    ++worker.stats.nodes;
+    if (++worker.pendingNodes >= NODE_BATCH) {
+        flushNodes(worker);
+    }
+    if (m_stop.load(std::memory_order_relaxed)) {
+        return false;
+    }
+    if (depth >= Solver::MAX_DEPTH) {
+        m_depthLimited = true;
+        return false;
+    }
+
+    size_t pathSize = worker.path.size();
+    Board board = position;
+    Solver::autoPlay(board, worker.path, hash);
+    if (board.isWon()) {
+        return true;
+    }
+    if (!m_table.insert(hash, depth)) {
+        worker.path.resize(pathSize);
+        return false;
+    }
+
+    Solver::Candidate candidates[Solver::MAX_CANDIDATES];
+    int count = Solver::collectCandidates(board, candidates);
+    for (int i = 0; i < count && !m_stop.load(std::memory_order_relaxed); ++i) {
+        // Есть простаивающие потоки, а своя очередь пуста - отдаём им
+        // оставшиеся ветви узла, себе оставляем текущую
+        if (i + 1 < count && m_idle.load(std::memory_order_relaxed) > 0 &&
+            m_queues[worker.index]->size.load(std::memory_order_relaxed) == 0) {
+            for (int j = count - 1; j > i; --j) {
+                Task task;
+                task.board = board;
+                task.hash = hash;
+                task.path = worker.path;
+                task.depth = depth + 1;
+                Solver::playCandidate(task.board, candidates[j], task.path, task.hash);
+                pushTask(worker.index, std::move(task));
+                ++worker.stats.donated;
+            }
+            count = i + 1;
+        }
+
+        size_t mark = worker.path.size();
+        Board child = board;
+        std::uint64_t childHash = hash;
+        Solver::playCandidate(child, candidates[i], worker.path, childHash);
+        if (search(worker, child, childHash, depth + 1)) {
+            return true;
+        }
+        worker.path.resize(mark);
+    }
+
+    worker.path.resize(pathSize);
+    return false;
+}
@@ -3,8 +3,11 @@
 #include <iostream>
 
 Pile::Pile(PileType type, const sf::Vector2f& position)
-    : m_type(type), m_position(position)
+    : m_type(type), m_position(position), m_version(0), m_laidOut(0)
 {
+    // Стопка никогда не держит больше колоды, и новые игры не выделяют память
+    m_cards.reserve(52);
+
     // Устанавливаем стратегии в зависимости от типа стопки
     switch (type) {
         case PileType::STOCK:
@@ -51,6 +54,7 @@ void Pile::addCard(std::shared_ptr<Card> card) {
     }
 
     m_cards.push_back(card);
+    ++m_version;
 
     // Устанавливаем указатель на стопку для карты
     card->setPile(this);
@@ -65,6 +69,8 @@ std::shared_ptr<Card> Pile::removeTopCard() {
 
     std::shared_ptr<Card> card = m_cards.back();
     m_cards.pop_back();
+    ++m_version;
+    invalidateLayout(m_cards.size());
 
     // Очищаем указатель на стопку в карте
     card->setPile(nullptr);
@@ -107,6 +113,8 @@ std::vector<std::shared_ptr<Card>> Pile::removeCards(size_t index) {
     }
 
     m_cards.erase(m_cards.begin() + index, m_cards.end());
+    ++m_version;
+    invalidateLayout(index);
 
     // НЕ вызываем updateAfterCardRemoval здесь!
     // Просто обновляем позиции оставшихся карт
@@ -115,6 +123,32 @@ std::vector<std::shared_ptr<Card>> Pile::removeCards(size_t index) {
     return removedCards;
 }
 
+void Pile::clear() {
+    for (const auto& card : m_cards) {
+        card->setPile(nullptr);
+    }
+    m_cards.clear();
+    ++m_version;
+    m_laidOut = 0;
+}
+
+void Pile::transferCards(size_t index, Pile& target) {
+    if (index >= m_cards.size() || &target == this) {
+        return;
+    }
+    for (size_t i = index; i < m_cards.size(); ++i) {
+        m_cards[i]->setPile(&target);
+        target.m_cards.push_back(m_cards[i]);
+    }
+    m_cards.erase(m_cards.begin() + index, m_cards.end());
+    ++m_version;
+    ++target.m_version;
+    invalidateLayout(index);
+
+    update();
+    target.update();
+}
+
 std::shared_ptr<Card> Pile::getTopCard() const {
     if (m_cards.empty()) {
         return nullptr;
@@ -132,15 +166,16 @@ std::shared_ptr<Card> Pile::getCardAt(size_t index) const {
 }
 
 size_t Pile::getCardIndex(const sf::Vector2f& point) const {
-    // Ищем индекс карты под указанной точкой с конца (сверху вниз)
-    for (int i = static_cast<int>(m_cards.size()) - 1; i >= 0; --i) {
-        if (m_cards[i]->contains(point) && m_cards[i]->isFaceUp()) {
-            if (Card::isDebugMode()) {
-                std::cout << "Найдена карта на индексе " << i << " в позиции ("
-                          << point.x << "," << point.y << ")" << std::endl;
-            }
-            return static_cast<size_t>(i);
+    // Верхняя карта под точкой находится по геометрии раскладки, без перебора.
+    // Закрытые карты лежат только под открытыми, поэтому если верхняя из
+    // накрывающих закрыта, открытой под точкой нет
+    size_t index = m_layoutStrategy ? m_layoutStrategy->cardAt(m_cards, point) : m_cards.size();
+    if (index < m_cards.size() && m_cards[index]->isFaceUp()) {
+        if (Card::isDebugMode()) {
+            std::cout << "Найдена карта на индексе " << index << " в позиции ("
+                      << point.x << "," << point.y << ")" << std::endl;
         }
+        return index;
     }
 
     if (Card::isDebugMode()) {
@@ -229,32 +264,53 @@ bool Pile::contains(const sf::Vector2f& point) const {
         return contains;
     }
 
-    // Иначе проверяем, содержит ли любая карта указанную точку
-    for (const auto& card : m_cards) {
-        if (card->contains(point)) {
-            if (Card::isDebugMode()) {
-                std::cout << "Клик по карте Ранг=" << static_cast<int>(card->getRank())
-                          << ", Масть=" << static_cast<int>(card->getSuit())
-                          << " в стопке типа " << static_cast<int>(m_type) << std::endl;
-            }
-            return true;
-        }
+    // Иначе проверяем, накрывает ли точку какая-нибудь карта: сначала
+    // прямоугольник всей стопки, затем карту по геометрии раскладки
+    if (!getBounds().contains(point) || !m_layoutStrategy) {
+        return false;
+    }
+    size_t index = m_layoutStrategy->cardAt(m_cards, point);
+    if (index == m_cards.size()) {
+        return false;
     }
+    if (Card::isDebugMode()) {
+        const auto& card = m_cards[index];
+        std::cout << "Клик по карте Ранг=" << static_cast<int>(card->getRank())
+                  << ", Масть=" << static_cast<int>(card->getSuit())
+                  << " в стопке типа " << static_cast<int>(m_type) << std::endl;
+    }
+    return true;
+}
 
-    return false;
+sf::FloatRect Pile::getBounds() const {
+    if (m_cards.empty()) {
+        return sf::FloatRect(m_position.x, m_position.y, CARD_WIDTH_VISUAL, CARD_HEIGHT_VISUAL);
+    }
+    // Раскладка - веер от нижней карты к верхней, крайние карты покрывают всё
+    sf::FloatRect first = m_cards.front()->getBounds();
+    sf::FloatRect last = m_cards.back()->getBounds();
+    float left = std::min(first.left, last.left);
+    float top = std::min(first.top, last.top);
+    float right = std::max(first.left + first.width, last.left + last.width);
+    float bottom = std::max(first.top + first.height, last.top + last.height);
+    return sf::FloatRect(left, top, right - left, bottom - top);
 }
 
 void Pile::update() {
-    // Обновляем позиции всех карт в стопке
-    for (size_t i = 0; i < m_cards.size(); ++i) {
-        if (!m_cards[i]->isDragging() && m_layoutStrategy) {
-            m_layoutStrategy->layout(m_cards[i], i, m_position);
-        }
+    // Карты ниже m_laidOut не сдвигались; перетаскиваемые карты уже сняты
+    // со стопки, поэтому расставлять можно все карты выше подряд
+    if (m_laidOut == m_cards.size()) {
+        return;
+    }
+    if (m_layoutStrategy) {
+        m_layoutStrategy->layout(m_cards, m_laidOut, m_position);
     }
+    m_laidOut = m_cards.size();
 }
 
 void Pile::setLayoutStrategy(std::unique_ptr<LayoutStrategy> strategy) {
     m_layoutStrategy = std::move(strategy);
+    m_laidOut = 0;
 }
 
 void Pile::setValidationStrategy(std::unique_ptr<ValidationStrategy> strategy) {
@@ -262,6 +318,22 @@ void Pile::setValidationStrategy(std::unique_ptr<ValidationStrategy> strategy) {
 }
 
 void Pile::draw(sf::RenderTarget& target, sf::RenderStates states) const {
+    drawEmptyFrame(target, states);
+
+    // Рисуем все карты в стопке
+    for (const auto& card : m_cards) {
+        target.draw(*card, states);
+    }
+
+    drawDebugMarker(target, states);
+}
+
+void Pile::drawFrame(sf::RenderTarget& target, sf::RenderStates states) const {
+    drawEmptyFrame(target, states);
+    drawDebugMarker(target, states);
+}
+
+void Pile::drawEmptyFrame(sf::RenderTarget& target, sf::RenderStates states) const {
     // Рисуем пустую рамку для стопки
     if (m_cards.empty()) {
         sf::RectangleShape emptyPile(sf::Vector2f(CARD_WIDTH_VISUAL, CARD_HEIGHT_VISUAL));
@@ -271,12 +343,9 @@ void Pile::draw(sf::RenderTarget& target, sf::RenderStates states) const {
         emptyPile.setOutlineThickness(2.0f);
         target.draw(emptyPile, states);
     }
+}
 
-    // Рисуем все карты в стопке
-    for (const auto& card : m_cards) {
-        target.draw(*card, states);
-    }
-
+void Pile::drawDebugMarker(sf::RenderTarget& target, sf::RenderStates states) const {
     // Отладочная информация для визуализации типа стопки
     if (Card::isDebugMode()) {
         // Используем прямоугольник с цветом для обозначения типа стопки
@@ -387,6 +456,7 @@ bool Pile::addCards(const std::vector<Card*>& cards) {
         cardShared->setPile(this);
         m_cards.push_back(cardShared);
     }
+    ++m_version;
 
     // Обновляем позиции всех карт
     update();
@@ -402,7 +472,9 @@ void Pile::removeCard(Card* card) {
         });
 
     if (it != m_cards.end()) {
+        invalidateLayout(static_cast<size_t>(it - m_cards.begin()));
         m_cards.erase(it);
+        ++m_version;
     }
 }
 
@@ -423,7 +495,9 @@ void Pile::removeCards(const std::vector<Card*>& cards) {
             (*it)->setPile(nullptr);
 
             // Удаляем карту из списка
+            invalidateLayout(static_cast<size_t>(it - m_cards.begin()));
             m_cards.erase(it);
+            ++m_version;
         }
     }
 
@@ -436,6 +510,7 @@ void Pile::updateAfterCardRemoval() {
     if (!m_cards.empty() && !m_cards.back()->isFaceUp() &&
         m_type == PileType::TABLEAU) {
         m_cards.back()->flip();
+        ++m_version;
     }
 
     // Обновляем позиции всех карт
@@ -0,0 +1,54 @@
+#include "RenderScheduler.hpp"
+#include <algorithm>
+
+const sf::Int32 RenderScheduler::POLL_INTERVAL_MS;
+
+// Первый кадр рисуется всегда
+RenderScheduler::RenderScheduler()
+    : m_frameStart(sf::Time::Zero), m_idle(sf::Time::Zero), m_deadline(sf::Time::Zero), m_hasDeadline(false),
+      m_dirty(true), m_animating(false) {
+}
+
+void RenderScheduler::wakeIn(sf::Time delay) {
+    sf::Time deadline = m_clock.getElapsedTime() + delay;
+    if (!m_hasDeadline || deadline < m_deadline) {
+        m_deadline = deadline;
+        m_hasDeadline = true;
+    }
+}
+
+bool RenderScheduler::waitEvent(sf::Window& window, sf::Event& event) {
+    bool hasDeadline = m_hasDeadline;
+    m_hasDeadline = false;
+    if (needsFrame()) {
+        return window.pollEvent(event);
+    }
+
+    sf::Time start = m_clock.getElapsedTime();
+    bool received = false;
+    while (window.isOpen()) {
+        if (window.pollEvent(event)) {
+            received = true;
+            break;
+        }
+        sf::Time now = m_clock.getElapsedTime();
+        if (hasDeadline && now >= m_deadline) {
+            break;
+        }
+        sf::Time pause = sf::milliseconds(POLL_INTERVAL_MS);
+        if (hasDeadline) {
+            pause = std::min(pause, m_deadline - now);
+        }
+        sf::sleep(pause);
+    }
+    m_idle += m_clock.getElapsedTime() - start;
+    return received;
+}
+
+sf::Time RenderScheduler::beginFrame() {
+    sf::Time now = m_clock.getElapsedTime();
+    sf::Time delta = now - m_frameStart - m_idle;
+    m_frameStart = now;
+    m_idle = sf::Time::Zero;
+    return delta;
+}
@@ -0,0 +1,248 @@
+#include "Replay.hpp"
+#include "BinaryIO.hpp"
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <type_traits>
+
+static const char MAGIC[4] = {'K', 'R', 'P', 'L'};
+static const std::uint32_t VERSION = 1;
+static const std::size_t HEADER_SIZE = 16;
+static const std::size_t STEP_SIZE = 9;
+static const std::size_t CHECKPOINT_SIZE = 5 + sizeof(Board);
+
+// Board состоит только из байтов, поэтому снимок пишется как есть
+static_assert(std::is_trivially_copyable<Board>::value && alignof(Board) == 1, "Board must be plain bytes");
+
+const char* const ReplayRecorder::DEFAULT_PATH = "lastgame.replay";
+
+ReplayRecorder::ReplayRecorder() : m_stepCount(0) {
+}
+
+bool ReplayRecorder::start(const std::string& path, std::uint32_t dealNumber, const Board& board) {
+    stop();
+    m_file.open(path, std::ios::binary | std::ios::trunc);
+    if (!m_file) {
+        m_file.close();
+        return false;
+    }
+
+    m_board = board;
+    m_stepCount = 0;
+    m_startTime = std::chrono::steady_clock::now();
+
+    unsigned char header[HEADER_SIZE] = {};
+    std::memcpy(header, MAGIC, sizeof(MAGIC));
+    writeU32(header + 4, VERSION);
+    writeU32(header + 8, dealNumber);
+    header[12] = board.drawCount;
+    header[13] = static_cast<unsigned char>(CHECKPOINT_INTERVAL);
+    m_file.write(reinterpret_cast<const char*>(header), sizeof(header));
+
+    writeCheckpoint();
+    return static_cast<bool>(m_file);
+}
+
+void ReplayRecorder::stop() {
+    if (m_file.is_open()) {
+        m_file.close();
+    }
+    m_file.clear();
+}
+
+void ReplayRecorder::recordMove(const Move& move) {
+    if (!isRecording()) {
+        return;
+    }
+    Move applied = move;
+    applyMove(m_board, applied);
+    writeStep('M', move);
+}
+
+void ReplayRecorder::recordUndo(const Move& move) {
+    if (!isRecording()) {
+        return;
+    }
+    undoMove(m_board, move);
+    writeStep('U', move);
+}
+
+void ReplayRecorder::writeStep(char kind, const Move& move) {
+    auto millis = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() -
+                                                                        m_startTime).count();
+
+    unsigned char record[STEP_SIZE];
+    record[0] = static_cast<unsigned char>(kind);
+    record[1] = move.from;
+    record[2] = move.to;
+    record[3] = move.count;
+    record[4] = move.flags;
+    writeU32(record + 5, static_cast<std::uint32_t>(millis));
+    m_file.write(reinterpret_cast<const char*>(record), sizeof(record));
+    ++m_stepCount;
+
+    if (m_stepCount % CHECKPOINT_INTERVAL == 0) {
+        writeCheckpoint();
+    }
+
+    // Шаги игрока редки, а запись должна пережить аварийное завершение
+    m_file.flush();
+}
+
+void ReplayRecorder::writeCheckpoint() {
+    unsigned char record[CHECKPOINT_SIZE];
+    record[0] = 'C';
+    writeU32(record + 1, m_stepCount);
+    std::memcpy(record + 5, &m_board, sizeof(Board));
+    m_file.write(reinterpret_cast<const char*>(record), sizeof(record));
+}
+
+ReplayPlayer::ReplayPlayer() : m_dealNumber(0), m_drawCount(1), m_position(0) {
+}
+
+bool ReplayPlayer::open(const std::string& path) {
+    m_steps.clear();
+    m_checkpoints.clear();
+    m_position = 0;
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+    std::vector<unsigned char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (data.size() < HEADER_SIZE || std::memcmp(data.data(), MAGIC, sizeof(MAGIC)) != 0 ||
+        readU32(data.data() + 4) != VERSION) {
+        return false;
+    }
+    m_dealNumber = readU32(data.data() + 8);
+    m_drawCount = data[12];
+
+    std::size_t offset = HEADER_SIZE;
+    while (offset < data.size()) {
+        const unsigned char* record = data.data() + offset;
+        std::size_t left = data.size() - offset;
+
+        if ((record[0] == 'M' || record[0] == 'U') && left >= STEP_SIZE) {
+            ReplayStep step;
+            step.move.from = record[1];
+            step.move.to = record[2];
+            step.move.count = record[3];
+            step.move.flags = record[4];
+            step.undo = record[0] == 'U';
+            step.millis = readU32(record + 5);
+            if (step.move.from >= PILE_COUNT || step.move.to >= PILE_COUNT || step.move.count == 0) {
+                break;
+            }
+            m_steps.push_back(step);
+            offset += STEP_SIZE;
+        } else if (record[0] == 'C' && left >= CHECKPOINT_SIZE) {
+            Board board;
+            std::memcpy(&board, record + 5, sizeof(Board));
+            if (readU32(record + 1) != m_steps.size() || !board.isValid()) {
+                break;
+            }
+            m_checkpoints.emplace_back(m_steps.size(), board);
+            offset += CHECKPOINT_SIZE;
+        } else {
+            // Неизвестная запись или оборванный хвост
+            break;
+        }
+    }
+
+    if (m_checkpoints.empty() || m_checkpoints.front().first != 0) {
+        m_steps.clear();
+        m_checkpoints.clear();
+        return false;
+    }
+    validate();
+    m_board = m_checkpoints.front().second;
+    return true;
+}
+
+void ReplayPlayer::seek(std::size_t step) {
+    if (m_checkpoints.empty()) {
+        return;
+    }
+    step = std::min(step, m_steps.size());
+
+    // Последний снимок не позже нужного шага
+    auto it = std::upper_bound(m_checkpoints.begin(), m_checkpoints.end(), step,
+                               [](std::size_t value, const std::pair<std::size_t, Board>& checkpoint) {
+                                   return value < checkpoint.first;
+                               });
+    --it;
+
+    // Вперёд от текущей позиции, если она ближе снимка
+    if (m_position > step || m_position < it->first) {
+        m_board = it->second;
+        m_position = it->first;
+    }
+    while (m_position < step) {
+        applyStep(m_steps[m_position++]);
+    }
+}
+
+bool ReplayPlayer::stepForward() {
+    if (m_position >= m_steps.size()) {
+        return false;
+    }
+    applyStep(m_steps[m_position++]);
+    return true;
+}
+
+bool ReplayPlayer::stepBackward() {
+    if (m_position == 0) {
+        return false;
+    }
+    seek(m_position - 1);
+    return true;
+}
+
+// Шаг применим: допустимый ход или отмена допустимого хода
+static bool applyCheckedStep(Board& board, const ReplayStep& step) {
+    if (!step.undo) {
+        if (!isLegalMove(board, step.move)) {
+            return false;
+        }
+        Move applied = step.move;
+        applyMove(board, applied);
+        return true;
+    }
+
+    return undoMoveChecked(board, step.move);
+}
+
+void ReplayPlayer::validate() {
+    // Один проход при открытии: дальше шаги применяются без проверок.
+    // Запись обрезается на первом шаге, который не сходится с позицией,
+    // или на снимке, который расходится с проигранными шагами
+    Board board = m_checkpoints.front().second;
+    std::size_t checkpoint = 1;
+    std::size_t step = 0;
+    for (; step < m_steps.size(); ++step) {
+        if (checkpoint < m_checkpoints.size() && m_checkpoints[checkpoint].first == step) {
+            if (m_checkpoints[checkpoint].second != board) {
+                break;
+            }
+            ++checkpoint;
+        }
+        if (!applyCheckedStep(board, m_steps[step])) {
+            break;
+        }
+    }
+    if (checkpoint < m_checkpoints.size() && m_checkpoints[checkpoint].first == step &&
+        m_checkpoints[checkpoint].second == board) {
+        ++checkpoint;
+    }
+    m_steps.resize(step);
+    m_checkpoints.resize(checkpoint);
+}
+
+void ReplayPlayer::applyStep(const ReplayStep& step) {
+    if (step.undo) {
+        undoMove(m_board, step.move);
+    } else {
+        Move applied = step.move;
+        applyMove(m_board, applied);
+    }
+}
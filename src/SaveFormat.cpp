@@ -0,0 +1,271 @@
+#include "SaveFormat.hpp"
+#include "UndoHistory.hpp"
+#include <cstring>
+#include <fstream>
+#include <utility>
+
+static const char MAGIC[4] = {'K', 'S', 'A', 'V'};
+static const std::size_t MAX_PAYLOAD_SIZE = 0xFFFF;
+
+// Упаковка по битам, младшие биты первыми
+class BitWriter {
+public:
+    explicit BitWriter(std::vector<unsigned char>& out) : m_out(out), m_bit(0) {}
+
+    void write(std::uint32_t value, int bits) {
+        for (int i = 0; i < bits; ++i) {
+            if (m_bit == 0) {
+                m_out.push_back(0);
+            }
+            if ((value >> i) & 1u) {
+                m_out.back() = static_cast<unsigned char>(m_out.back() | (1u << m_bit));
+            }
+            m_bit = (m_bit + 1) & 7;
+        }
+    }
+
+private:
+    std::vector<unsigned char>& m_out;
+    int m_bit;
+};
+
+// Чтение с проверкой границ: за концом данных читаются нули и взводится ошибка
+class BitReader {
+public:
+    BitReader(const unsigned char* bytes, std::size_t size) : m_bytes(bytes), m_size(size), m_pos(0), m_overrun(false) {}
+
+    std::uint32_t read(int bits) {
+        std::uint32_t value = 0;
+        for (int i = 0; i < bits; ++i, ++m_pos) {
+            if (m_pos >= m_size * 8) {
+                m_overrun = true;
+                return 0;
+            }
+            if ((m_bytes[m_pos / 8] >> (m_pos % 8)) & 1u) {
+                value |= 1u << i;
+            }
+        }
+        return value;
+    }
+
+    bool overrun() const { return m_overrun; }
+
+    // Все данные прочитаны, а добивка до байта нулевая
+    bool atCleanEnd() const {
+        if (m_overrun || (m_pos + 7) / 8 != m_size) {
+            return false;
+        }
+        return m_pos % 8 == 0 || (m_bytes[m_size - 1] >> (m_pos % 8)) == 0;
+    }
+
+private:
+    const unsigned char* m_bytes;
+    std::size_t m_size;
+    std::size_t m_pos;
+    bool m_overrun;
+};
+
+bool encodeSave(const SaveData& data, std::vector<unsigned char>& out) {
+    const Board& board = data.board;
+    if (!board.isValid() || data.history.size() > UndoHistory::DEFAULT_CAPACITY) {
+        return false;
+    }
+    for (int column = 0; column < Board::TABLEAU_COUNT; ++column) {
+        if (board.faceDown[column] > 7) {
+            return false;
+        }
+    }
+
+    out.assign(SAVE_HEADER_SIZE, 0);
+    BitWriter writer(out);
+    writer.write(data.dealNumber, 32);
+    writer.write(data.seconds > 0xFFFFFFu ? 0xFFFFFFu : data.seconds, 24);
+    writer.write(static_cast<std::uint32_t>(data.score), 32);
+    writer.write(data.sequence, 32);
+    writer.write(data.moves > 0xFFFFFFu ? 0xFFFFFFu : data.moves, 24);
+    writer.write(data.undos, 16);
+    writer.write(data.hints, 16);
+    writer.write(board.drawCount == 3 ? 1 : 0, 1);
+
+    writer.write(board.talonSize, 5);
+    writer.write(board.wasteSize, 5);
+    for (int i = 0; i < board.talonSize; ++i) {
+        writer.write(board.talon[i], 6);
+    }
+    for (int i = 0; i < Board::FOUNDATION_COUNT; ++i) {
+        writer.write(board.foundation[i], 6);
+    }
+    for (int column = 0; column < Board::TABLEAU_COUNT; ++column) {
+        writer.write(board.tableauSize[column], 5);
+        writer.write(board.faceDown[column], 3);
+        for (int i = 0; i < board.tableauSize[column]; ++i) {
+            writer.write(board.tableau[column][i], 6);
+        }
+    }
+
+    writer.write(static_cast<std::uint32_t>(data.history.size()), 15);
+    for (const Move& move : data.history) {
+        if (move.from >= PILE_COUNT || move.to >= PILE_COUNT || move.count > 31) {
+            return false;
+        }
+        writer.write(move.from, 4);
+        writer.write(move.to, 4);
+        writer.write(move.count, 5);
+        writer.write(move.flipped() ? 1 : 0, 1);
+    }
+
+    std::size_t payloadSize = out.size() - SAVE_HEADER_SIZE;
+    if (payloadSize > MAX_PAYLOAD_SIZE) {
+        return false;
+    }
+    std::uint32_t crc = crc32(out.data() + SAVE_HEADER_SIZE, payloadSize);
+    std::memcpy(out.data(), MAGIC, sizeof(MAGIC));
+    out[4] = SAVE_FORMAT_VERSION;
+    out[5] = 0;
+    writeU16(out.data() + 6, static_cast<std::uint16_t>(payloadSize));
+    writeU32(out.data() + 8, crc);
+    return true;
+}
+
+SaveError decodeSave(const unsigned char* bytes, std::size_t size, SaveData& data) {
+    if (size < SAVE_HEADER_SIZE) {
+        return SaveError::TRUNCATED;
+    }
+    if (std::memcmp(bytes, MAGIC, sizeof(MAGIC)) != 0) {
+        return SaveError::BAD_MAGIC;
+    }
+    if (bytes[4] > SAVE_FORMAT_VERSION) {
+        return SaveError::FUTURE_VERSION;
+    }
+    if (bytes[4] == 0) {
+        return SaveError::BAD_DATA;
+    }
+    std::size_t payloadSize = readU16(bytes + 6);
+    if (size < SAVE_HEADER_SIZE + payloadSize) {
+        return SaveError::TRUNCATED;
+    }
+    if (size > SAVE_HEADER_SIZE + payloadSize) {
+        return SaveError::BAD_DATA;
+    }
+    std::uint32_t crc = readU32(bytes + 8);
+    const unsigned char* payload = bytes + SAVE_HEADER_SIZE;
+    if (crc32(payload, payloadSize) != crc) {
+        return SaveError::BAD_CHECKSUM;
+    }
+
+    // Каждое поле проверяется до использования как индекса или размера
+    BitReader reader(payload, payloadSize);
+    SaveData result;
+    Board& board = result.board;
+    result.dealNumber = reader.read(32);
+    result.seconds = reader.read(24);
+    result.score = static_cast<std::int32_t>(reader.read(32));
+    if (bytes[4] >= 2) {
+        result.sequence = reader.read(32);
+    }
+    if (bytes[4] >= 3) {
+        result.moves = reader.read(24);
+        result.undos = static_cast<std::uint16_t>(reader.read(16));
+        result.hints = static_cast<std::uint16_t>(reader.read(16));
+    }
+    board.drawCount = reader.read(1) ? 3 : 1;
+
+    board.talonSize = static_cast<std::uint8_t>(reader.read(5));
+    board.wasteSize = static_cast<std::uint8_t>(reader.read(5));
+    if (board.talonSize > Board::TALON_CAPACITY || board.wasteSize > board.talonSize) {
+        return SaveError::BAD_DATA;
+    }
+    for (int i = 0; i < board.talonSize; ++i) {
+        board.talon[i] = static_cast<CardId>(reader.read(6));
+    }
+    for (int i = 0; i < Board::FOUNDATION_COUNT; ++i) {
+        board.foundation[i] = static_cast<CardId>(reader.read(6));
+        if (board.foundation[i] != NO_CARD && board.foundation[i] >= CARD_COUNT) {
+            return SaveError::BAD_DATA;
+        }
+    }
+    for (int column = 0; column < Board::TABLEAU_COUNT; ++column) {
+        board.tableauSize[column] = static_cast<std::uint8_t>(reader.read(5));
+        board.faceDown[column] = static_cast<std::uint8_t>(reader.read(3));
+        if (board.tableauSize[column] > Board::TABLEAU_CAPACITY) {
+            return SaveError::BAD_DATA;
+        }
+        for (int i = 0; i < board.tableauSize[column]; ++i) {
+            board.tableau[column][i] = static_cast<CardId>(reader.read(6));
+        }
+    }
+    if (reader.overrun() || !board.isValid()) {
+        return SaveError::BAD_DATA;
+    }
+
+    std::size_t historySize = reader.read(15);
+    if (historySize > UndoHistory::DEFAULT_CAPACITY) {
+        return SaveError::BAD_DATA;
+    }
+    result.history.resize(historySize);
+    for (Move& move : result.history) {
+        move.from = static_cast<std::uint8_t>(reader.read(4));
+        move.to = static_cast<std::uint8_t>(reader.read(4));
+        move.count = static_cast<std::uint8_t>(reader.read(5));
+        move.flags = reader.read(1) ? Move::FLIPPED : 0;
+    }
+    if (!reader.atCleanEnd()) {
+        return SaveError::BAD_DATA;
+    }
+
+    // История должна откатываться от сохранённой позиции ход за ходом
+    Board previous = board;
+    for (std::size_t i = historySize; i > 0; --i) {
+        if (!undoMoveChecked(previous, result.history[i - 1])) {
+            return SaveError::BAD_DATA;
+        }
+    }
+
+    data = std::move(result);
+    return SaveError::NONE;
+}
+
+const char* saveErrorText(SaveError error) {
+    switch (error) {
+    case SaveError::NONE:
+        return "ok";
+    case SaveError::NOT_FOUND:
+        return "файл не найден";
+    case SaveError::TRUNCATED:
+        return "файл обрезан";
+    case SaveError::BAD_MAGIC:
+        return "не файл сохранения";
+    case SaveError::FUTURE_VERSION:
+        return "сохранение более новой версии игры";
+    case SaveError::BAD_CHECKSUM:
+        return "не совпадает контрольная сумма";
+    case SaveError::BAD_DATA:
+        return "невозможная позиция или история ходов";
+    }
+    return "неизвестная ошибка";
+}
+
+bool writeSaveFile(const std::string& path, const SaveData& data) {
+    std::vector<unsigned char> bytes;
+    if (!encodeSave(data, bytes)) {
+        return false;
+    }
+    return writeFileAtomic(path, bytes);
+}
+
+SaveError readSaveFile(const std::string& path, SaveData& data) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        return SaveError::NOT_FOUND;
+    }
+    std::streamoff size = file.tellg();
+    if (size < 0 || static_cast<std::size_t>(size) > SAVE_MAX_FILE_SIZE) {
+        return SaveError::BAD_DATA;
+    }
+    std::vector<unsigned char> bytes(static_cast<std::size_t>(size));
+    file.seekg(0);
+    if (!file.read(reinterpret_cast<char*>(bytes.data()), size)) {
+        return SaveError::TRUNCATED;
+    }
+    return decodeSave(bytes.data(), bytes.size(), data);
+}
@@ -0,0 +1,129 @@
+#include "SelfPlay.hpp"
+#include <chrono>
+
+int RandomPolicy::chooseMove(const Board& board, const MoveList& moves) {
+    (void)board;
+    return static_cast<int>(m_random.below(static_cast<std::uint32_t>(moves.size())));
+}
+
+int GreedyPolicy::chooseMove(const Board& board, const MoveList& moves) {
+    int best = -1;
+    int bestPriority = 1;
+    int stockMove = -1;
+    for (int i = 0; i < moves.size(); ++i) {
+        if (moves[i].isDraw() || moves[i].isRecycle()) {
+            stockMove = i;
+            continue;
+        }
+        // Перекладывания без открытия карты (приоритет 1 и ниже) ведут к циклам
+        int priority = hintPriority(board, moves[i]);
+        if (priority > bestPriority) {
+            best = i;
+            bestPriority = priority;
+        }
+    }
+    return best >= 0 ? best : stockMove;
+}
+
+SolverPolicy::SolverPolicy(const SolverLimits& limits) : m_solver(limits), m_step(0) {
+}
+
+void SolverPolicy::startGame(const Board& board) {
+    Solution solution = m_solver.solve(board);
+    m_plan.clear();
+    if (solution.result == SolveResult::WINNABLE) {
+        m_plan = solution.moves;
+    }
+    m_step = 0;
+}
+
+int SolverPolicy::chooseMove(const Board& board, const MoveList& moves) {
+    if (m_step < m_plan.size()) {
+        const Move& planned = m_plan[m_step];
+        for (int i = 0; i < moves.size(); ++i) {
+            if (moves[i] == planned) {
+                ++m_step;
+                return i;
+            }
+        }
+        // Позиция разошлась с решением - доигрываем без него
+        m_plan.clear();
+    }
+    return m_fallback.chooseMove(board, moves);
+}
+
+std::unique_ptr<PlayPolicy> makePlayPolicy(const std::string& name, std::uint64_t seed,
+                                           const SolverLimits& limits) {
+    if (name == "random") {
+        return std::unique_ptr<PlayPolicy>(new RandomPolicy(seed));
+    }
+    if (name == "greedy") {
+        return std::unique_ptr<PlayPolicy>(new GreedyPolicy());
+    }
+    if (name == "solver") {
+        return std::unique_ptr<PlayPolicy>(new SolverPolicy(limits));
+    }
+    return nullptr;
+}
+
+void SelfPlayStats::add(const GameRecord& record) {
+    ++games;
+    wins += record.won ? 1 : 0;
+    moves += static_cast<std::uint64_t>(record.moves);
+    foundationCards += static_cast<std::uint64_t>(record.foundationCards);
+    seconds += record.seconds;
+}
+
+void SelfPlayStats::merge(const SelfPlayStats& other) {
+    games += other.games;
+    wins += other.wins;
+    moves += other.moves;
+    foundationCards += other.foundationCards;
+    seconds += other.seconds;
+}
+
+GameRecord playGame(std::uint32_t dealNumber, PlayPolicy& policy, int drawCount, int maxMoves) {
+    auto startTime = std::chrono::steady_clock::now();
+
+    GameRecord record;
+    record.dealNumber = dealNumber;
+
+    Board board = dealBoard(dealNumber, drawCount);
+    policy.startGame(board);
+
+    MoveList moves;
+    bool recycled = false;
+    bool progressSinceRecycle = false;
+    while (record.moves < maxMoves && !board.isWon()) {
+        moves.generate(board);
+        if (moves.empty()) {
+            break;
+        }
+        int choice = policy.chooseMove(board, moves);
+        if (choice < 0 || choice >= moves.size()) {
+            break;
+        }
+
+        Move move = moves[choice];
+        if (move.isRecycle()) {
+            if (recycled && !progressSinceRecycle) {
+                break;
+            }
+            recycled = true;
+            progressSinceRecycle = false;
+        } else if (!move.isDraw()) {
+            progressSinceRecycle = true;
+        }
+        applyMove(board, move);
+        ++record.moves;
+    }
+
+    record.won = board.isWon();
+    for (int i = 0; i < Board::FOUNDATION_COUNT; ++i) {
+        if (board.foundation[i] != NO_CARD) {
+            record.foundationCards += cardRank(board.foundation[i]);
+        }
+    }
+    record.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    return record;
+}
@@ -0,0 +1,305 @@
+#include "Solver.hpp"
+#include "Zobrist.hpp"
+#include <algorithm>
+
+Solver::Solver(const SolverLimits& limits)
+    : m_limits(limits),
+      m_table(limits.tableBytes, limits.replacement),
+      m_tableUsed(false),
+      m_nodes(0),
+      m_aborted(false),
+      m_depthLimited(false) {}
+
+Solution Solver::solve(const Board& board) {
+    if (m_tableUsed) {
+        m_table.clear();
+    }
+    m_tableUsed = true;
+    m_path.clear();
+    m_nodes = 0;
+    m_aborted = false;
+    m_depthLimited = false;
+    m_startTime = std::chrono::steady_clock::now();
+
+    Solution solution;
+    if (search(board, zobristHash(board), 0)) {
+        solution.result = SolveResult::WINNABLE;
+        solution.moves = m_path;
+    } else {
+        bool complete = !m_aborted && !m_depthLimited;
+        solution.result = complete ? SolveResult::UNWINNABLE : SolveResult::UNKNOWN;
+    }
+    solution.nodes = m_nodes;
+    solution.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - m_startTime).count();
+    solution.table = m_table.getStats();
+    return solution;
+}
+
+bool Solver::isSafeToFoundation(const Board& board, CardId card) {
+    int rank = cardRank(card);
+    if (rank <= 2) {
+        return true;
+    }
+
+    // Собранный ранг каждой масти
+    int suitRank[4] = {0, 0, 0, 0};
+    for (int i = 0; i < Board::FOUNDATION_COUNT; ++i) {
+        if (board.foundation[i] != NO_CARD) {
+            suitRank[cardSuit(board.foundation[i])] = cardRank(board.foundation[i]);
+        }
+    }
+
+    // Карты другого цвета на ранг ниже уже в базах, а вторая масть того же
+    // цвета не отстаёт больше чем на два ранга
+    bool red = cardIsRed(card);
+    for (int suit = 0; suit < 4; ++suit) {
+        if (suit == cardSuit(card)) {
+            continue;
+        }
+        bool suitRed = (suit == 1 || suit == 2);
+        int needed = (suitRed != red) ? rank - 1 : rank - 2;
+        if (suitRank[suit] < needed) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Solver::outOfBudget() {
+    if (m_limits.maxNodes && m_nodes >= m_limits.maxNodes) {
+        return true;
+    }
+    // Часы опрашиваем не на каждом узле
+    if (m_limits.maxSeconds > 0.0 && (m_nodes & 1023) == 0) {
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - m_startTime).count();
+        return elapsed >= m_limits.maxSeconds;
+    }
+    return false;
+}
+
+static void play(Board& board, Move move, std::vector<Move>& path, std::uint64_t& hash) {
+    hash = zobristUpdate(hash, board, move);
+    applyMove(board, move);
+    path.push_back(move);
+}
+
+void Solver::autoPlay(Board& board, std::vector<Move>& path, std::uint64_t& hash) {
+    bool moved = true;
+    while (moved) {
+        moved = false;
+
+        CardId top = board.wasteTop();
+        if (top != NO_CARD && isSafeToFoundation(board, top)) {
+            int foundation = findFoundationFor(board, top);
+            if (foundation >= 0) {
+                play(board, Move{static_cast<std::uint8_t>(WASTE_PILE),
+                                 static_cast<std::uint8_t>(FOUNDATION_FIRST + foundation), 1, 0}, path, hash);
+                moved = true;
+            }
+        }
+
+        for (int column = 0; column < Board::TABLEAU_COUNT; ++column) {
+            top = board.tableauTop(column);
+            if (top != NO_CARD && isSafeToFoundation(board, top)) {
+                int foundation = findFoundationFor(board, top);
+                if (foundation >= 0) {
+                    play(board, Move{static_cast<std::uint8_t>(TABLEAU_FIRST + column),
+                                     static_cast<std::uint8_t>(FOUNDATION_FIRST + foundation), 1, 0}, path, hash);
+                    moved = true;
+                }
+            }
+        }
+    }
+}
+
+int Solver::collectCandidates(const Board& board, Candidate* candidates) {
+    int count = 0;
+    auto add = [candidates, &count](const Move& move, std::uint8_t talonIndex, bool recycle, int score) {
+        if (count < MAX_CANDIDATES) {
+            candidates[count++] = Candidate{move, talonIndex, recycle, score};
+        }
+    };
+
+    // Все пустые стопки равноценны, рассматриваем только первую
+    int firstEmpty = -1;
+    for (int column = 0; column < Board::TABLEAU_COUNT; ++column) {
+        if (board.tableauSize[column] == 0) {
+            firstEmpty = column;
+            break;
+        }
+    }
+    auto usableTarget = [&board, firstEmpty](int pile) {
+        int column = pile - TABLEAU_FIRST;
+        return board.tableauSize[column] > 0 || column == firstEmpty;
+    };
+
+    // Есть ли король, которому пригодится пустая стопка: в колоде
+    // или не в самом низу игровой стопки
+    bool kingWithoutColumn = false;
+    for (int i = 0; i < board.talonSize && !kingWithoutColumn; ++i) {
+        kingWithoutColumn = cardRank(board.talon[i]) == 13;
+    }
+    for (int column = 0; column < Board::TABLEAU_COUNT && !kingWithoutColumn; ++column) {
+        for (int i = 1; i < board.tableauSize[column]; ++i) {
+            if (cardRank(board.tableau[column][i]) == 13) {
+                kingWithoutColumn = true;
+                break;
+            }
+        }
+    }
+
+    // Ходы без участия колоды
+    MoveList moves;
+    moves.generate(board);
+    for (const Move& move : moves) {
+        if (move.from == WASTE_PILE || move.from == STOCK_PILE) {
+            continue;
+        }
+        if (isTableauPile(move.to) && !usableTarget(move.to)) {
+            continue;
+        }
+
+        // Карты из баз обратно не возвращаем: такие ходы почти никогда не
+        // нужны для выигрыша, а перебор раздувают сильно
+        if (isFoundationPile(move.from)) {
+            continue;
+        }
+
+        int column = move.from - TABLEAU_FIRST;
+        int start = board.tableauSize[column] - move.count;
+        bool reveals = start > 0 && start == board.faceDown[column];
+
+        if (isFoundationPile(move.to)) {
+            add(move, NO_TALON, false, reveals ? 120 + board.faceDown[column] : 100);
+        } else if (start == 0) {
+            // Освобождать стопку имеет смысл, только если на её место
+            // сможет лечь король; короля с пустого места на пустое не двигаем
+            if (kingWithoutColumn && board.tableauSize[move.to - TABLEAU_FIRST] > 0) {
+                add(move, NO_TALON, false, 30);
+            }
+        } else if (reveals) {
+            add(move, NO_TALON, false, 90 + board.faceDown[column]);
+        } else {
+            // Часть открытой последовательности переносим, только если
+            // открывшаяся карта сразу уходит в базу
+            if (findFoundationFor(board, board.tableau[column][start - 1]) >= 0) {
+                add(move, NO_TALON, false, 10);
+            }
+        }
+    }
+
+    // Карты колоды: текущая верхняя карта сброса, карты, до которых можно
+    // добраться взятием, и карты после переворота сброса
+    bool reachable[Board::TALON_CAPACITY] = {};
+    bool needsRecycle[Board::TALON_CAPACITY] = {};
+    int size = board.talonSize;
+    if (board.wasteSize > 0) {
+        reachable[board.wasteSize - 1] = true;
+    }
+    for (int position = board.wasteSize; position < size;) {
+        position = std::min(position + board.drawCount, size);
+        reachable[position - 1] = true;
+    }
+    for (int position = 0; position < size;) {
+        position = std::min(position + board.drawCount, size);
+        if (!reachable[position - 1]) {
+            reachable[position - 1] = true;
+            needsRecycle[position - 1] = true;
+        }
+    }
+
+    for (int index = 0; index < size; ++index) {
+        if (!reachable[index]) {
+            continue;
+        }
+        CardId card = board.talon[index];
+        std::uint8_t talonIndex = static_cast<std::uint8_t>(index);
+        // Ближние карты пробуем раньше дальних
+        int distance = index + 1 >= board.wasteSize ? index + 1 - board.wasteSize : size;
+
+        int foundation = findFoundationFor(board, card);
+        if (foundation >= 0) {
+            Move move{static_cast<std::uint8_t>(WASTE_PILE),
+                      static_cast<std::uint8_t>(FOUNDATION_FIRST + foundation), 1, 0};
+            add(move, talonIndex, needsRecycle[index], 80 - distance);
+        }
+        for (int column = 0; column < Board::TABLEAU_COUNT; ++column) {
+            if (canPlaceOnTableau(board, card, column) && usableTarget(TABLEAU_FIRST + column)) {
+                Move move{static_cast<std::uint8_t>(WASTE_PILE),
+                          static_cast<std::uint8_t>(TABLEAU_FIRST + column), 1, 0};
+                add(move, talonIndex, needsRecycle[index], 60 - distance);
+            }
+        }
+    }
+
+    // Сортировка вставками по убыванию оценки, при равенстве - в порядке генерации
+    for (int i = 1; i < count; ++i) {
+        Candidate candidate = candidates[i];
+        int j = i;
+        while (j > 0 && candidates[j - 1].score < candidate.score) {
+            candidates[j] = candidates[j - 1];
+            --j;
+        }
+        candidates[j] = candidate;
+    }
+    return count;
+}
+
+void Solver::playCandidate(Board& board, const Candidate& candidate, std::vector<Move>& path,
+                          std::uint64_t& hash) {
+    if (candidate.talonIndex != NO_TALON) {
+        // Докладываем колоду до нужной карты
+        if (candidate.recycle) {
+            while (board.stockSize() > 0) {
+                play(board, Move{static_cast<std::uint8_t>(STOCK_PILE), static_cast<std::uint8_t>(WASTE_PILE),
+                                 static_cast<std::uint8_t>(std::min<int>(board.drawCount, board.stockSize())), 0}, path, hash);
+            }
+            play(board, Move{static_cast<std::uint8_t>(WASTE_PILE), static_cast<std::uint8_t>(STOCK_PILE),
+                             board.wasteSize, 0}, path, hash);
+        }
+        while (board.wasteSize < candidate.talonIndex + 1) {
+            play(board, Move{static_cast<std::uint8_t>(STOCK_PILE), static_cast<std::uint8_t>(WASTE_PILE),
+                             static_cast<std::uint8_t>(std::min<int>(board.drawCount, board.stockSize())), 0}, path, hash);
+        }
+    }
+    play(board, candidate.move, path, hash);
+}
+
+bool Solver::search(const Board& position, std::uint64_t hash, int depth) {
+    ++m_nodes;
+    if (outOfBudget()) {
+        m_aborted = true;
+        return false;
+    }
+    if (depth >= MAX_DEPTH) {
+        m_depthLimited = true;
+        return false;
+    }
+
+    size_t pathSize = m_path.size();
+    Board board = position;
+    autoPlay(board, m_path, hash);
+    if (board.isWon()) {
+        return true;
+    }
+    if (!m_table.insert(hash, depth)) {
+        m_path.resize(pathSize);
+        return false;
+    }
+
+    Candidate candidates[MAX_CANDIDATES];
+    int count = collectCandidates(board, candidates);
+    for (int i = 0; i < count && !m_aborted; ++i) {
+        size_t mark = m_path.size();
+        Board child = board;
+        std::uint64_t childHash = hash;
+        playCandidate(child, candidates[i], m_path, childHash);
+        if (search(child, childHash, depth + 1)) {
+            return true;
+        }
+        m_path.resize(mark);
+    }
+
+    m_path.resize(pathSize);
+    return false;
+}
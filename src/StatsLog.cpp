@@ -0,0 +1,334 @@
+#include "StatsLog.hpp"
+#include "BinaryIO.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <sstream>
+#include <system_error>
+#include <nlohmann/json.hpp>
+
+static const char MAGIC[4] = {'K', 'S', 'T', 'L'};
+static const std::uint32_t VERSION = 1;
+static const std::size_t HEADER_SIZE = 8;
+static const std::size_t RECORD_SIZE = 24;
+
+const int StatsLog::SYNC_INTERVAL_MS;
+const std::uint32_t StatsLog::COMPACT_EVENTS;
+
+static std::uint32_t idHash(const std::string& id) {
+    return crc32(reinterpret_cast<const unsigned char*>(id.data()), id.size());
+}
+
+static void encodeRecord(const StatsEvent& event, std::uint32_t sequence, unsigned char* record) {
+    record[0] = static_cast<unsigned char>(event.type);
+    record[1] = event.won ? 1 : 0;
+    record[2] = 0;
+    record[3] = 0;
+    writeU32(record + 4, event.value);
+    writeU32(record + 8, event.seconds);
+    writeU32(record + 12, static_cast<std::uint32_t>(event.score));
+    writeU32(record + 16, sequence);
+    writeU32(record + 20, crc32(record, 20));
+}
+
+static StatsEvent decodeRecord(const unsigned char* record) {
+    StatsEvent event;
+    event.type = static_cast<StatsEventType>(record[0]);
+    event.won = record[1] != 0;
+    event.value = readU32(record + 4);
+    event.seconds = readU32(record + 8);
+    event.score = static_cast<std::int32_t>(readU32(record + 12));
+    return event;
+}
+
+void applyStatsEvent(GameStats& stats, const StatsEvent& event) {
+    switch (event.type) {
+    case StatsEventType::GAME_STARTED:
+        stats.currentMoves = 0;
+        stats.currentTime = 0;
+        stats.currentScore = 0;
+        break;
+    case StatsEventType::MOVE:
+        stats.currentMoves++;
+        break;
+    case StatsEventType::GAME_WON:
+        stats.gamesWon++;
+        break;
+    case StatsEventType::GAME_OVER:
+        stats.gamesPlayed++;
+        if (event.won) {
+            stats.gamesWon++;
+            stats.totalMoves += static_cast<int>(event.value);
+            stats.fastestWin = std::min(stats.fastestWin, static_cast<int>(event.seconds));
+            stats.bestScore = std::max(stats.bestScore, static_cast<int>(event.score));
+        }
+        stats.currentMoves = 0;
+        stats.currentTime = 0;
+        stats.currentScore = 0;
+        break;
+    case StatsEventType::ACHIEVEMENT:
+        break;
+    }
+}
+
+StatsEvent achievementEvent(const std::string& id) {
+    StatsEvent event;
+    event.type = StatsEventType::ACHIEVEMENT;
+    event.value = idHash(id);
+    return event;
+}
+
+// Статистика и открытое достижение (id ищется по CRC-32 из события)
+static void foldEvent(StatsSummary& state, const StatsEvent& event, const std::vector<std::string>& knownIds) {
+    applyStatsEvent(state.stats, event);
+    if (event.type != StatsEventType::ACHIEVEMENT) {
+        return;
+    }
+    for (const std::string& id : knownIds) {
+        if (idHash(id) == event.value) {
+            if (std::find(state.unlocked.begin(), state.unlocked.end(), id) == state.unlocked.end()) {
+                state.unlocked.push_back(id);
+            }
+            break;
+        }
+    }
+}
+
+// Снимок - stats.json прежнего вида; sequence - последнее вошедшее событие
+static bool readSnapshot(const std::string& path, StatsSummary& state, std::uint32_t& sequence) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        return false;
+    }
+    try {
+        nlohmann::json j;
+        file >> j;
+
+        StatsSummary loaded;
+        loaded.stats.gamesPlayed = j["gamesPlayed"];
+        loaded.stats.gamesWon = j["gamesWon"];
+        loaded.stats.totalMoves = j["totalMoves"];
+        loaded.stats.totalCards = j["totalCards"];
+        loaded.stats.fastestWin = j["fastestWin"];
+        loaded.stats.bestScore = j["bestScore"];
+        for (auto& ach : j["achievements"]) {
+            if (ach["unlocked"].get<bool>()) {
+                loaded.unlocked.push_back(ach["id"].get<std::string>());
+            }
+        }
+        sequence = j.value("sequence", 0u);
+        state = std::move(loaded);
+        return true;
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+static bool writeSnapshot(const std::string& path, const StatsSummary& state, std::uint32_t sequence,
+                          const std::vector<std::string>& knownIds) {
+    nlohmann::json j;
+    j["gamesPlayed"] = state.stats.gamesPlayed;
+    j["gamesWon"] = state.stats.gamesWon;
+    j["totalMoves"] = state.stats.totalMoves;
+    j["totalCards"] = state.stats.totalCards;
+    j["fastestWin"] = state.stats.fastestWin;
+    j["bestScore"] = state.stats.bestScore;
+    j["sequence"] = sequence;
+
+    nlohmann::json achievements = nlohmann::json::array();
+    for (const std::string& id : knownIds) {
+        nlohmann::json ach;
+        ach["id"] = id;
+        ach["unlocked"] = std::find(state.unlocked.begin(), state.unlocked.end(), id) != state.unlocked.end();
+        achievements.push_back(ach);
+    }
+    j["achievements"] = achievements;
+
+    std::ostringstream text;
+    text << std::setw(4) << j << std::endl;
+    std::string bytes = text.str();
+
+    return writeFileAtomic(path, bytes.data(), bytes.size());
+}
+
+StatsLog::StatsLog()
+    : m_sequence(0), m_syncRequested(false), m_syncCount(0), m_stopping(false), m_file(nullptr),
+      m_stateSequence(0), m_sinceSnapshot(0) {
+}
+
+StatsLog::~StatsLog() {
+    close();
+}
+
+StatsSummary StatsLog::open(const std::string& snapshotPath, const std::string& logPath,
+                          const std::vector<std::string>& knownIds) {
+    close();
+    m_snapshotPath = snapshotPath;
+    m_logPath = logPath;
+    m_knownIds = knownIds;
+
+    StatsSummary state;
+    std::uint32_t sequence = 0;
+    readSnapshot(m_snapshotPath, state, sequence);
+
+    // Хвост журнала: события новее снимка, подряд и с верной CRC
+    std::ifstream file(m_logPath, std::ios::binary);
+    std::vector<unsigned char> bytes;
+    if (file) {
+        bytes.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+    if (bytes.size() >= HEADER_SIZE && std::memcmp(bytes.data(), MAGIC, sizeof(MAGIC)) == 0 &&
+        readU32(bytes.data() + 4) == VERSION) {
+        for (std::size_t offset = HEADER_SIZE; offset + RECORD_SIZE <= bytes.size(); offset += RECORD_SIZE) {
+            const unsigned char* record = bytes.data() + offset;
+            if (crc32(record, 20) != readU32(record + 20)) {
+                break;
+            }
+            std::uint32_t recordSequence = readU32(record + 16);
+            if (recordSequence <= sequence) {
+                // Уже в снимке
+                continue;
+            }
+            if (recordSequence != sequence + 1) {
+                break;
+            }
+            foldEvent(state, decodeRecord(record), m_knownIds);
+            sequence = recordSequence;
+        }
+    }
+
+    // Текущая партия не переживает перезапуск
+    state.stats.currentMoves = 0;
+    state.stats.currentTime = 0;
+    state.stats.currentScore = 0;
+
+    m_sequence = sequence;
+    m_state = state;
+    m_stateSequence = sequence;
+    m_sinceSnapshot = 0;
+    m_pending.clear();
+    m_syncRequested = false;
+    m_stopping = false;
+    try {
+        m_thread = std::thread(&StatsLog::writerLoop, this);
+    } catch (const std::system_error&) {
+    }
+    return state;
+}
+
+void StatsLog::close() {
+    if (!m_thread.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_wake.notify_one();
+    m_thread.join();
+    if (m_file) {
+        std::fclose(m_file);
+        m_file = nullptr;
+    }
+}
+
+void StatsLog::append(const StatsEvent& event) {
+    if (!m_thread.joinable()) {
+        return;
+    }
+    unsigned char record[RECORD_SIZE];
+    encodeRecord(event, ++m_sequence, record);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pending.insert(m_pending.end(), record, record + RECORD_SIZE);
+    }
+    m_wake.notify_one();
+}
+
+void StatsLog::sync() {
+    if (!m_thread.joinable()) {
+        return;
+    }
+    std::unique_lock<std::mutex> lock(m_mutex);
+    std::uint64_t target = m_syncCount + 1;
+    m_syncRequested = true;
+    m_wake.notify_one();
+    m_synced.wait(lock, [this, target] { return m_syncCount >= target; });
+}
+
+void StatsLog::writerLoop() {
+    // Свежий журнал при запуске: отрезает оборванную при сбое запись
+    compact();
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+        m_wake.wait(lock, [this] { return m_stopping || m_syncRequested || !m_pending.empty(); });
+
+        // Ждём до SYNC_INTERVAL_MS, пока не попросят свернуть журнал или
+        // не пора остановиться: события за это время уходят одной записью
+        if (!m_stopping && !m_syncRequested) {
+            m_wake.wait_for(lock, std::chrono::milliseconds(SYNC_INTERVAL_MS),
+                            [this] { return m_stopping || m_syncRequested; });
+        }
+
+        std::vector<unsigned char> records;
+        records.swap(m_pending);
+        bool syncRequested = m_syncRequested;
+        m_syncRequested = false;
+        bool stopping = m_stopping;
+        lock.unlock();
+
+        if (!records.empty()) {
+            appendRecords(records);
+        }
+        if (syncRequested || (stopping && m_sinceSnapshot > 0) || m_sinceSnapshot >= COMPACT_EVENTS) {
+            compact();
+        }
+
+        lock.lock();
+        if (syncRequested) {
+            ++m_syncCount;
+            m_synced.notify_all();
+        }
+        if (stopping && m_pending.empty()) {
+            break;
+        }
+    }
+}
+
+bool StatsLog::appendRecords(const std::vector<unsigned char>& records) {
+    for (std::size_t offset = 0; offset + RECORD_SIZE <= records.size(); offset += RECORD_SIZE) {
+        foldEvent(m_state, decodeRecord(records.data() + offset), m_knownIds);
+        m_stateSequence = readU32(records.data() + offset + 16);
+        ++m_sinceSnapshot;
+    }
+    if (!m_file) {
+        return false;
+    }
+    return std::fwrite(records.data(), 1, records.size(), m_file) == records.size() && syncFile(m_file);
+}
+
+bool StatsLog::compact() {
+    if (!writeSnapshot(m_snapshotPath, m_state, m_stateSequence, m_knownIds)) {
+        return false;
+    }
+    m_sinceSnapshot = 0;
+    if (m_file) {
+        std::fclose(m_file);
+        m_file = nullptr;
+    }
+
+    // Журнал начинается заново с пустого; сбой до замены файла безопасен:
+    // старые события не новее уже записанного снимка
+    unsigned char header[HEADER_SIZE];
+    std::memcpy(header, MAGIC, sizeof(MAGIC));
+    writeU32(header + 4, VERSION);
+    if (!writeFileAtomic(m_logPath, header, sizeof(header))) {
+        return false;
+    }
+    m_file = std::fopen(m_logPath.c_str(), "ab");
+    return m_file != nullptr;
+}
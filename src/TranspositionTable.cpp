@@ -0,0 +1,128 @@
+#include "TranspositionTable.hpp"
+#include <algorithm>
+
+TranspositionTable::TranspositionTable(std::size_t memoryBytes, ReplacementPolicy policy)
+    : m_bucketCount(1), m_bucketMask(0), m_policy(policy) {
+    // Наибольшая степень двойки корзин, которая помещается в лимит
+    while (m_bucketCount * 2 * sizeof(Bucket) <= memoryBytes) {
+        m_bucketCount *= 2;
+    }
+    m_bucketMask = m_bucketCount - 1;
+    m_buckets.reset(new Bucket[m_bucketCount]);
+    m_counters.reset(new Counters[COUNTER_STRIPES]);
+    clear();
+}
+
+std::uint64_t TranspositionTable::pack(std::uint64_t hash, int depth) {
+    // Глубина хранится со сдвигом на 1, чтобы занятая ячейка не была нулём
+    std::uint64_t stored = static_cast<std::uint64_t>(std::min<int>(std::max(depth, 0), DEPTH_MASK - 1) + 1);
+    return (hash & ~DEPTH_MASK) | stored;
+}
+
+bool TranspositionTable::insert(std::uint64_t hash, int depth) {
+    Counters& counters = countersFor(hash);
+    counters.probes.fetch_add(1, std::memory_order_relaxed);
+
+    Bucket& bucket = bucketFor(hash);
+    std::uint64_t entry = pack(hash, depth);
+
+    // Вторая попытка нужна, если свободную ячейку успел занять другой поток
+    for (int attempt = 0; attempt < 2; ++attempt) {
+        int emptySlot = -1;
+        int deepestSlot = -1;
+        std::uint64_t deepestEntry = 0;
+
+        for (int i = 0; i < BUCKET_SIZE; ++i) {
+            std::uint64_t current = bucket.slots[i].load(std::memory_order_acquire);
+            if (sameKey(current, hash)) {
+                // Запоминаем наименьшую глубину, на которой встречалась позиция
+                if (depthOf(current) > depth) {
+                    bucket.slots[i].compare_exchange_strong(current, entry, std::memory_order_acq_rel);
+                }
+                counters.hits.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            if (current == 0) {
+                if (emptySlot < 0) {
+                    emptySlot = i;
+                }
+            } else if (deepestSlot < 0 || depthOf(current) > depthOf(deepestEntry)) {
+                deepestSlot = i;
+                deepestEntry = current;
+            }
+        }
+
+        if (emptySlot >= 0) {
+            std::uint64_t expected = 0;
+            if (bucket.slots[emptySlot].compare_exchange_strong(expected, entry, std::memory_order_acq_rel)) {
+                counters.stores.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+            if (sameKey(expected, hash)) {
+                counters.hits.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            continue;
+        }
+
+        // Корзина заполнена - решает политика замещения
+        bool replace = m_policy == ReplacementPolicy::ALWAYS ||
+                       (m_policy == ReplacementPolicy::KEEP_SHALLOWEST && depth <= depthOf(deepestEntry));
+        if (replace &&
+            bucket.slots[deepestSlot].compare_exchange_strong(deepestEntry, entry, std::memory_order_acq_rel)) {
+            counters.replaced.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+        break;
+    }
+
+    counters.rejected.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool TranspositionTable::contains(std::uint64_t hash) const {
+    const Bucket& bucket = bucketFor(hash);
+    for (int i = 0; i < BUCKET_SIZE; ++i) {
+        if (sameKey(bucket.slots[i].load(std::memory_order_acquire), hash)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void TranspositionTable::clear() {
+    for (std::size_t i = 0; i < m_bucketCount; ++i) {
+        for (auto& slot : m_buckets[i].slots) {
+            slot.store(0, std::memory_order_relaxed);
+        }
+    }
+    for (int i = 0; i < COUNTER_STRIPES; ++i) {
+        m_counters[i].probes = 0;
+        m_counters[i].hits = 0;
+        m_counters[i].stores = 0;
+        m_counters[i].replaced = 0;
+        m_counters[i].rejected = 0;
+    }
+}
+
+TranspositionStats TranspositionTable::getStats() const {
+    TranspositionStats stats;
+    for (int i = 0; i < COUNTER_STRIPES; ++i) {
+        stats.probes += m_counters[i].probes.load(std::memory_order_relaxed);
+        stats.hits += m_counters[i].hits.load(std::memory_order_relaxed);
+        stats.stores += m_counters[i].stores.load(std::memory_order_relaxed);
+        stats.replaced += m_counters[i].replaced.load(std::memory_order_relaxed);
+        stats.rejected += m_counters[i].rejected.load(std::memory_order_relaxed);
+    }
+
+    // Заполненность считаем по самим ячейкам: при гонках счётчики приблизительны
+    for (std::size_t i = 0; i < m_bucketCount; ++i) {
+        for (const auto& slot : m_buckets[i].slots) {
+            if (slot.load(std::memory_order_relaxed) != 0) {
+                ++stats.used;
+            }
+        }
+    }
+    stats.capacity = static_cast<std::uint64_t>(m_bucketCount) * BUCKET_SIZE;
+    return stats;
+}
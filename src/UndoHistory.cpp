@@ -0,0 +1,41 @@
+#include "UndoHistory.hpp"
+
+UndoHistory::UndoHistory(std::size_t capacity)
+    : m_moves(capacity > 0 ? capacity : 1), m_start(0), m_undoCount(0), m_redoCount(0) {
+}
+
+void UndoHistory::push(const Move& move) {
+    m_redoCount = 0;
+    if (m_undoCount == m_moves.size()) {
+        // Буфер заполнен - забываем самый старый ход
+        m_start = slot(1);
+        --m_undoCount;
+    }
+    m_moves[slot(m_undoCount)] = move;
+    ++m_undoCount;
+}
+
+void UndoHistory::clear() {
+    m_start = 0;
+    m_undoCount = 0;
+    m_redoCount = 0;
+}
+
+Move UndoHistory::popUndo() {
+    if (m_undoCount == 0) {
+        return Move();
+    }
+    --m_undoCount;
+    ++m_redoCount;
+    return m_moves[slot(m_undoCount)];
+}
+
+Move UndoHistory::popRedo() {
+    if (m_redoCount == 0) {
+        return Move();
+    }
+    Move move = m_moves[slot(m_undoCount)];
+    ++m_undoCount;
+    --m_redoCount;
+    return move;
+}
@@ -0,0 +1,124 @@
+#include "Zobrist.hpp"
+
+// Индекс «под картой ничего нет» (карта лежит на дне стопки)
+static const int BOTTOM = CARD_COUNT;
+
+struct ZobristKeys {
+    std::uint64_t tableau[CARD_COUNT + 1][CARD_COUNT][2];
+    std::uint64_t talon[CARD_COUNT];
+    std::uint64_t cursor[Board::TALON_CAPACITY + 1];
+    std::uint64_t foundation[CARD_COUNT];
+
+    ZobristKeys() {
+        // Фиксированное зерно: хэши одинаковы между запусками
+        std::uint64_t state = 0x5EED5EED5EED5EEDULL;
+        auto next = [&state]() {
+            std::uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            return z ^ (z >> 31);
+        };
+        for (auto& below : tableau) {
+            for (auto& card : below) {
+                card[0] = next();
+                card[1] = next();
+            }
+        }
+        for (auto& key : talon) {
+            key = next();
+        }
+        for (auto& key : cursor) {
+            key = next();
+        }
+        for (auto& key : foundation) {
+            key = next();
+        }
+    }
+};
+
+static const ZobristKeys& keys() {
+    static const ZobristKeys instance;
+    return instance;
+}
+
+std::uint64_t zobristHash(const Board& board) {
+    const ZobristKeys& k = keys();
+    std::uint64_t hash = 0;
+
+    for (int column = 0; column < Board::TABLEAU_COUNT; ++column) {
+        int below = BOTTOM;
+        for (int i = 0; i < board.tableauSize[column]; ++i) {
+            CardId card = board.tableau[column][i];
+            hash ^= k.tableau[below][card][i >= board.faceDown[column]];
+            below = card;
+        }
+    }
+
+    for (int i = 0; i < board.talonSize; ++i) {
+        hash ^= k.talon[board.talon[i]];
+    }
+    if (board.drawCount != 1) {
+        hash ^= k.cursor[board.wasteSize];
+    }
+
+    for (int i = 0; i < Board::FOUNDATION_COUNT; ++i) {
+        if (board.foundation[i] != NO_CARD) {
+            hash ^= k.foundation[board.foundation[i]];
+        }
+    }
+    return hash;
+}
+
+std::uint64_t zobristUpdate(std::uint64_t hash, const Board& before, const Move& move) {
+    const ZobristKeys& k = keys();
+    bool useCursor = before.drawCount != 1;
+
+    if (move.isDraw() || move.isRecycle()) {
+        if (useCursor) {
+            int after = move.isDraw() ? before.wasteSize + move.count : 0;
+            hash ^= k.cursor[before.wasteSize] ^ k.cursor[after];
+        }
+        return hash;
+    }
+
+    // Снимаем карту (нижнюю из перемещаемых) с исходной стопки
+    CardId card;
+    if (move.from == WASTE_PILE) {
+        card = before.wasteTop();
+        hash ^= k.talon[card];
+        if (useCursor) {
+            hash ^= k.cursor[before.wasteSize] ^ k.cursor[before.wasteSize - 1];
+        }
+    } else if (isFoundationPile(move.from)) {
+        card = before.foundation[move.from - FOUNDATION_FIRST];
+        hash ^= k.foundation[card];
+        if (cardRank(card) > 1) {
+            hash ^= k.foundation[card - 1];
+        }
+    } else {
+        int column = move.from - TABLEAU_FIRST;
+        int start = before.tableauSize[column] - move.count;
+        card = before.tableau[column][start];
+        int below = start > 0 ? before.tableau[column][start - 1] : BOTTOM;
+        hash ^= k.tableau[below][card][1];
+
+        // Открывается карта под перемещёнными
+        if (start > 0 && start == before.faceDown[column]) {
+            int belowBelow = start > 1 ? before.tableau[column][start - 2] : BOTTOM;
+            hash ^= k.tableau[belowBelow][below][0] ^ k.tableau[belowBelow][below][1];
+        }
+    }
+
+    // Кладём на целевую; остальные карты группы лежат на тех же картах
+    if (isFoundationPile(move.to)) {
+        CardId top = before.foundation[move.to - FOUNDATION_FIRST];
+        if (top != NO_CARD) {
+            hash ^= k.foundation[top];
+        }
+        hash ^= k.foundation[card];
+    } else {
+        CardId top = before.tableauTop(move.to - TABLEAU_FIRST);
+        hash ^= k.tableau[top == NO_CARD ? BOTTOM : top][card][1];
+    }
+    return hash;
+}
@@ -12,6 +12,8 @@
 #include "Context.hpp"
 #include "AnimationManager.hpp"
 #include "Card.hpp"
+#include "HudLabel.hpp"
+#include "RenderScheduler.hpp"
 #include <iostream>
 #include <fstream>
 
@@ -136,6 +138,9 @@ int main() {
     game.setScoreSystem(scoreSystem);
     game.initialize();
 
+    // Продолжаем партию, если прошлый запуск оборвался, и включаем журнал
+    SaveManager::getInstance().recoverGame(game);
+
     // Create state manager
     GameStateManager stateManager;
     AppContext::stateManager = &stateManager;
@@ -143,13 +148,18 @@ int main() {
     // Первоначальное состояние
     stateManager.changeState(std::make_unique<PlayingState>());
 
+    // Кадр рисуется только по событию, смене таймера/счёта или во время анимации
+    RenderScheduler scheduler;
+
     // Setup callbacks
-    timer->setTimerCallback([&statsManager](int seconds) {
+    timer->setTimerCallback([&statsManager, &scheduler](int seconds) {
         statsManager.setCurrentTime(seconds);
+        scheduler.invalidate();
     });
 
-    scoreSystem->setScoreCallback([&statsManager](int score) {
+    scoreSystem->setScoreCallback([&statsManager, &scheduler](int score) {
         statsManager.setCurrentScore(score);
+        scheduler.invalidate();
     });
 
     statsManager.setAchievementCallback([audioAvailable](const Achievement& achievement) {
@@ -185,16 +195,21 @@ int main() {
     });
 
     // Game loop
-    sf::Clock clock;
     bool gameRunning = true;
 
     while (window.isOpen() && gameRunning) {
         try {
-            sf::Time deltaTime = clock.restart();
+            // Без нужного кадра спим здесь до события или следующей секунды таймера
+            sf::Event event;
+            bool hasEvent = scheduler.waitEvent(window, event);
+            sf::Time deltaTime = scheduler.beginFrame();
+            HudLabel::beginFrame();
 
             // Handle events
-            sf::Event event;
-            while (window.pollEvent(event)) {
+            for (; hasEvent; hasEvent = window.pollEvent(event)) {
+                // Любое событие может изменить экран (наведение, ход, размер окна)
+                scheduler.invalidate();
+
                 if (event.type == sf::Event::Closed) {
                     // Save game and stats before exit
                     SaveManager::getInstance().saveGame(game);
@@ -277,6 +292,19 @@ int main() {
                             }
                         }
                     }
+                    else if ((event.key.code == sf::Keyboard::Z || event.key.code == sf::Keyboard::Y) &&
+                             (sf::Keyboard::isKeyPressed(sf::Keyboard::LControl) ||
+                              sf::Keyboard::isKeyPressed(sf::Keyboard::RControl))) {
+                        // Undo with Ctrl+Z, redo with Ctrl+Y
+                        if (stateManager.getCurrentState() &&
+                            typeid(*stateManager.getCurrentState()) == typeid(PlayingState)) {
+                            if (event.key.code == sf::Keyboard::Z) {
+                                game.undo();
+                            } else {
+                                game.redo();
+                            }
+                        }
+                    }
                     else if (event.key.code == sf::Keyboard::H) {
                         // Hint with H
                         if (stateManager.getCurrentState() &&
@@ -308,30 +336,7 @@ int main() {
                 }
             }
 
-                        // Проверка победы (добавить ЗДЕСЬ)
-            if (game.hasPendingVictory()) {
-                // Сбрасываем флаг победы
-                game.resetPendingVictory();
-
-                // Останавливаем таймер
-                if (timer) timer->pause();
-
-                // Добавляем бонус за завершение
-                if (scoreSystem && timer) {
-                    scoreSystem->addCompletionBonus(timer->getElapsedSeconds());
-                }
-
-                // Обновляем статистику
-                StatsManager::getInstance().gameCompleted(true);
-
-                // Небольшая пауза для стабилизации состояния
-                sf::sleep(sf::milliseconds(300));
-
-                // Переходим на экран победы
-                stateManager.changeState(std::make_unique<VictoryState>());
-            }
-
-            // Проверка победы (добавить ЗДЕСЬ)
+            // Проверка победы
             if (game.hasPendingVictory()) {
                 // Сбрасываем флаг победы
                 game.resetPendingVictory();
@@ -345,6 +350,9 @@ int main() {
                 }
 
                 // Обновляем статистику
+                game.recordResult(true);
+                if (timer) StatsManager::getInstance().setCurrentTime(timer->getElapsedSeconds());
+                if (scoreSystem) StatsManager::getInstance().setCurrentScore(scoreSystem->getScore());
                 StatsManager::getInstance().gameCompleted(true);
 
                 // Небольшая пауза для стабилизации состояния
@@ -359,6 +367,8 @@ int main() {
                 stateManager.getCurrentState() &&
                 typeid(*stateManager.getCurrentState()) == typeid(PlayingState)) {
                 timer->update();
+                // Проснуться к смене секунды, чтобы обновить время на экране
+                scheduler.wakeIn(timer->getTimeToNextSecond());
             }
 
             // Update animations
@@ -369,6 +379,12 @@ int main() {
                 stateManager.update(deltaTime, game);
             }
 
+            scheduler.setAnimating(AnimationManager::getInstance().hasActiveAnimations() ||
+                                   (stateManager.getCurrentState() && stateManager.isAnimating(game)));
+            if (!scheduler.needsFrame() || !window.isOpen()) {
+                continue;
+            }
+
             // Clear window
             window.clear(gameSettings.tableColor);
 
@@ -379,6 +395,7 @@ int main() {
 
             // Display content
             window.display();
+            scheduler.frameRendered();
         }
         catch (const std::exception& e) {
             std::cerr << "Error in game loop: " << e.what() << std::endl;
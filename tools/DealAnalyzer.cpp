@@ -0,0 +1,446 @@
+// Консольный анализатор раздач: решает раздачи из диапазона номеров на всех
+// ядрах и пишет результаты по порядку номеров в двоичный файл или CSV.
+// Прерванный запуск продолжается с того же файла.
+//
+//   DealAnalyzer --from 1 --to 10000000 --out deals.bin [--csv] [--draw 3]
+//                [--time 1.0] [--nodes 2000000] [--threads 16] [--table-mb 16]
+//                [--threads-per-deal 4] [--database assets/deals.db]
+//
+// С --threads-per-deal N каждая раздача решается параллельным решателем
+// на N потоках, а одновременно решается --threads / N раздач: так долгие
+// раздачи не держат весь запуск на одном ядре. В конце печатается
+// статистика потоков решателя.
+//
+// С --database по готовому двоичному файлу собирается база раздач
+// (DealDatabase), по которой игра выбирает выигрышные раздачи.
+//
+// Двоичный формат (little-endian): заголовок 16 байт
+//   "KDAR", uint32 версия (2), uint32 карт за взятие, uint32 резерв
+// и записи по 24 байта
+//   uint32 номер раздачи, uint8 вердикт (0 - выигрышная, 1 - нет, 2 - неизвестно),
+//   uint8 резерв, uint16 длина решения, uint64 узлов, uint32 микросекунд,
+//   uint32 резерв.
+// CSV: строка заголовка, затем deal,verdict,length,nodes,micros.
+
+#include "BinaryIO.hpp"
+#include "Deal.hpp"
+#include "DealDatabase.hpp"
+#include "ParallelSolver.hpp"
+#include "Solver.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+static const char BINARY_MAGIC[4] = {'K', 'D', 'A', 'R'};
+static const std::uint32_t BINARY_VERSION = 2;
+static const std::size_t HEADER_SIZE = 16;
+static const std::size_t RECORD_SIZE = 24;
+static const char* CSV_HEADER = "deal,verdict,length,nodes,micros\n";
+
+struct Options {
+    std::uint64_t from = 1;
+    std::uint64_t to = 1000;
+    std::string output;
+    std::string database;
+    bool csv = false;
+    int drawCount = 1;
+    double seconds = 1.0;
+    std::uint64_t nodes = 2000000;
+    int threads = 0;
+    int threadsPerDeal = 1;
+    std::size_t tableMegabytes = 16;
+};
+
+struct DealRecord {
+    std::uint32_t deal = 0;
+    std::uint8_t verdict = 0;
+    std::uint16_t length = 0;
+    std::uint64_t nodes = 0;
+    std::uint32_t micros = 0;
+};
+
+static std::atomic<bool> g_interrupted(false);
+
+static void onSignal(int) {
+    g_interrupted = true;
+}
+
+static void printUsage() {
+    std::cerr << "Использование: DealAnalyzer --from N --to M --out FILE [--csv] [--draw 1|3]\n"
+                 "                    [--time SECONDS] [--nodes N] [--threads N] [--table-mb N]\n"
+                 "                    [--threads-per-deal N] [--database FILE]\n";
+}
+
+static bool parseOptions(int argc, char* argv[], Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto value = [&](const char* name) -> const char* {
+            if (i + 1 >= argc) {
+                std::cerr << "Не указано значение для " << name << std::endl;
+                return nullptr;
+            }
+            return argv[++i];
+        };
+
+        const char* v = nullptr;
+        if (arg == "--csv") {
+            options.csv = true;
+            continue;
+        }
+        if (!(v = value(arg.c_str()))) {
+            return false;
+        }
+        if (arg == "--from") {
+            options.from = std::strtoull(v, nullptr, 10);
+        } else if (arg == "--to") {
+            options.to = std::strtoull(v, nullptr, 10);
+        } else if (arg == "--out") {
+            options.output = v;
+        } else if (arg == "--database") {
+            options.database = v;
+        } else if (arg == "--draw") {
+            options.drawCount = std::atoi(v);
+        } else if (arg == "--time") {
+            options.seconds = std::atof(v);
+        } else if (arg == "--nodes") {
+            options.nodes = std::strtoull(v, nullptr, 10);
+        } else if (arg == "--threads") {
+            options.threads = std::atoi(v);
+        } else if (arg == "--threads-per-deal") {
+            options.threadsPerDeal = std::atoi(v);
+        } else if (arg == "--table-mb") {
+            options.tableMegabytes = static_cast<std::size_t>(std::atoi(v));
+        } else {
+            std::cerr << "Неизвестный параметр: " << arg << std::endl;
+            return false;
+        }
+    }
+
+    if (options.output.empty() || options.from > options.to || options.to > 0xFFFFFFFFULL ||
+        (options.drawCount != 1 && options.drawCount != 3) || options.threadsPerDeal < 1) {
+        return false;
+    }
+    if (!options.database.empty() && options.csv) {
+        std::cerr << "База раздач собирается только из двоичного файла" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+static void writeRecord(std::ofstream& file, const DealRecord& record, bool csv) {
+    if (csv) {
+        file << record.deal << ',' << static_cast<int>(record.verdict) << ',' << record.length << ','
+             << record.nodes << ',' << record.micros << '\n';
+        return;
+    }
+    unsigned char buffer[RECORD_SIZE] = {};
+    writeU32(buffer, record.deal);
+    buffer[4] = record.verdict;
+    writeU16(buffer + 6, record.length);
+    writeU64(buffer + 8, record.nodes);
+    writeU32(buffer + 16, record.micros);
+    file.write(reinterpret_cast<const char*>(buffer), RECORD_SIZE);
+}
+
+// Готовит файл к дописыванию: отрезает недописанный хвост и возвращает
+// первое ещё не решённый номер. false - файл не подходит к параметрам
+static bool prepareOutput(const Options& options, std::uint64_t& nextDeal) {
+    namespace fs = std::filesystem;
+    nextDeal = options.from;
+
+    std::error_code error;
+    if (!fs::exists(options.output, error) || fs::file_size(options.output, error) == 0) {
+        std::ofstream file(options.output, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            return false;
+        }
+        if (options.csv) {
+            file << CSV_HEADER;
+        } else {
+            unsigned char header[HEADER_SIZE] = {};
+            std::memcpy(header, BINARY_MAGIC, 4);
+            writeU32(header + 4, BINARY_VERSION);
+            writeU32(header + 8, static_cast<std::uint32_t>(options.drawCount));
+            file.write(reinterpret_cast<const char*>(header), HEADER_SIZE);
+        }
+        return static_cast<bool>(file);
+    }
+
+    std::uintmax_t size = fs::file_size(options.output, error);
+    std::ifstream file(options.output, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+
+    std::uintmax_t complete = 0;
+    bool haveRecord = false;
+    std::uint64_t lastDeal = 0;
+
+    if (options.csv) {
+        // Последняя строка без перевода строки не дописана
+        std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        if (content.compare(0, std::strlen(CSV_HEADER), CSV_HEADER) != 0) {
+            std::cerr << "Файл " << options.output << " не похож на вывод анализатора" << std::endl;
+            return false;
+        }
+        std::size_t end = content.rfind('\n');
+        complete = end + 1;
+        if (complete > std::strlen(CSV_HEADER)) {
+            std::size_t start = content.rfind('\n', end - 1) + 1;
+            lastDeal = std::strtoull(content.c_str() + start, nullptr, 10);
+            haveRecord = true;
+        }
+    } else {
+        unsigned char header[HEADER_SIZE] = {};
+        file.read(reinterpret_cast<char*>(header), HEADER_SIZE);
+        if (!file || std::memcmp(header, BINARY_MAGIC, 4) != 0 || readU32(header + 4) != BINARY_VERSION) {
+            std::cerr << "Файл " << options.output << " не похож на вывод анализатора" << std::endl;
+            return false;
+        }
+        if (readU32(header + 8) != static_cast<std::uint32_t>(options.drawCount)) {
+            std::cerr << "Файл записан для другого числа карт за взятие" << std::endl;
+            return false;
+        }
+        std::uintmax_t records = (size - HEADER_SIZE) / RECORD_SIZE;
+        complete = HEADER_SIZE + records * RECORD_SIZE;
+        if (records > 0) {
+            unsigned char record[RECORD_SIZE];
+            file.seekg(static_cast<std::streamoff>(complete - RECORD_SIZE));
+            file.read(reinterpret_cast<char*>(record), RECORD_SIZE);
+            lastDeal = readU32(record);
+            haveRecord = true;
+        }
+    }
+    file.close();
+
+    if (complete != size) {
+        fs::resize_file(options.output, complete, error);
+        if (error) {
+            return false;
+        }
+        std::cerr << "Отрезана недописанная запись в конце файла" << std::endl;
+    }
+    if (haveRecord) {
+        nextDeal = std::max<std::uint64_t>(options.from, lastDeal + 1);
+    }
+    return true;
+}
+
+// Переводит двоичный файл результатов в базу раздач
+static bool buildDatabase(const Options& options) {
+    std::ifstream file(options.output, std::ios::binary);
+    unsigned char header[HEADER_SIZE] = {};
+    unsigned char record[RECORD_SIZE];
+    file.read(reinterpret_cast<char*>(header), HEADER_SIZE);
+    if (!file.read(reinterpret_cast<char*>(record), RECORD_SIZE)) {
+        return false;
+    }
+
+    std::uint32_t expected = readU32(record);
+    DealDatabaseBuilder builder(expected, static_cast<int>(readU32(header + 8)));
+    do {
+        // База адресуется номером, поэтому пропусков быть не должно
+        if (readU32(record) != expected) {
+            std::cerr << "В результатах нет раздачи " << expected << std::endl;
+            return false;
+        }
+        builder.add(static_cast<SolveResult>(std::min<int>(record[4], 2)), readU16(record + 6), readU64(record + 8));
+        ++expected;
+    } while (file.read(reinterpret_cast<char*>(record), RECORD_SIZE));
+
+    if (!builder.write(options.database)) {
+        return false;
+    }
+    std::cerr << "База " << options.database << ": " << builder.getDealCount() << " раздач, выигрышных "
+              << builder.getWinnableCount() << std::endl;
+    return true;
+}
+
+// Суммирует статистику потоков параллельного решателя по раздачам
+static void addThreadStats(std::vector<SolverThreadStats>& total, const std::vector<SolverThreadStats>& threads) {
+    total.resize(std::max(total.size(), threads.size()));
+    for (std::size_t i = 0; i < threads.size(); ++i) {
+        total[i].nodes += threads[i].nodes;
+        total[i].tasks += threads[i].tasks;
+        total[i].steals += threads[i].steals;
+        total[i].donated += threads[i].donated;
+        total[i].seconds += threads[i].seconds;
+    }
+}
+
+static void printThreadStats(const std::vector<SolverThreadStats>& threads) {
+    for (std::size_t i = 0; i < threads.size(); ++i) {
+        const SolverThreadStats& stats = threads[i];
+        std::fprintf(stderr, "Поток решателя %zu: %llu узлов, %.0f в секунду, подзадач %llu, украдено %llu, отдано %llu\n",
+                     i, static_cast<unsigned long long>(stats.nodes), stats.nodesPerSecond(),
+                     static_cast<unsigned long long>(stats.tasks), static_cast<unsigned long long>(stats.steals),
+                     static_cast<unsigned long long>(stats.donated));
+    }
+}
+
+static int finish(const Options& options) {
+    if (!options.database.empty() && !buildDatabase(options)) {
+        std::cerr << "Не удалось собрать базу " << options.database << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage();
+        return 1;
+    }
+
+    std::uint64_t firstDeal = 0;
+    if (!prepareOutput(options, firstDeal)) {
+        std::cerr << "Не удалось подготовить файл " << options.output << std::endl;
+        return 1;
+    }
+    if (firstDeal > options.to) {
+        std::cerr << "Все раздачи диапазона уже решены" << std::endl;
+        return finish(options);
+    }
+    if (firstDeal != options.from) {
+        std::cerr << "Продолжаем с раздачи " << firstDeal << std::endl;
+    }
+
+    int threadCount = options.threads > 0 ? options.threads : static_cast<int>(std::thread::hardware_concurrency());
+    // Каждая раздача занимает threadsPerDeal потоков
+    int workerCount = std::max(threadCount / options.threadsPerDeal, 1);
+
+    SolverLimits limits;
+    limits.maxSeconds = options.seconds;
+    limits.maxNodes = options.nodes;
+    limits.tableBytes = options.tableMegabytes << 20;
+
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+
+    // Рабочие берут номера по очереди, писатель выводит результаты строго
+    // по порядку номеров, поэтому файл всегда содержит сплошной префикс
+    std::atomic<std::uint64_t> nextDeal(firstDeal);
+    std::mutex resultsMutex;
+    std::condition_variable resultsReady;
+    std::map<std::uint64_t, DealRecord> results;
+    std::atomic<int> activeWorkers(workerCount);
+    std::vector<SolverThreadStats> threadStats;
+
+    auto worker = [&]() {
+        std::unique_ptr<Solver> solver;
+        std::unique_ptr<ParallelSolver> parallelSolver;
+        if (options.threadsPerDeal > 1) {
+            parallelSolver = std::make_unique<ParallelSolver>(limits, options.threadsPerDeal);
+        } else {
+            solver = std::make_unique<Solver>(limits);
+        }
+        std::vector<SolverThreadStats> workerStats;
+
+        while (!g_interrupted) {
+            std::uint64_t deal = nextDeal.fetch_add(1);
+            if (deal > options.to) {
+                break;
+            }
+            Board board = dealBoard(static_cast<std::uint32_t>(deal), options.drawCount);
+            Solution solution;
+            if (parallelSolver) {
+                ParallelSolution parallel = parallelSolver->solve(board);
+                addThreadStats(workerStats, parallel.threads);
+                solution = std::move(parallel);
+            } else {
+                solution = solver->solve(board);
+            }
+
+            DealRecord record;
+            record.deal = static_cast<std::uint32_t>(deal);
+            record.verdict = static_cast<std::uint8_t>(solution.result);
+            record.length = static_cast<std::uint16_t>(std::min<std::size_t>(solution.moves.size(), 0xFFFF));
+            record.nodes = solution.nodes;
+            record.micros = static_cast<std::uint32_t>(std::min(solution.seconds * 1e6, 4e9));
+
+            std::lock_guard<std::mutex> lock(resultsMutex);
+            results[deal] = record;
+            resultsReady.notify_one();
+        }
+        {
+            std::lock_guard<std::mutex> lock(resultsMutex);
+            addThreadStats(threadStats, workerStats);
+        }
+        --activeWorkers;
+        resultsReady.notify_one();
+    };
+
+    std::vector<std::thread> workers;
+    for (int i = 0; i < workerCount; ++i) {
+        workers.emplace_back(worker);
+    }
+
+    std::ofstream output(options.output, std::ios::binary | std::ios::app);
+    std::uint64_t written = firstDeal;
+    std::uint64_t counts[3] = {0, 0, 0};
+    auto startTime = std::chrono::steady_clock::now();
+    auto lastReport = startTime;
+
+    while (true) {
+        std::vector<DealRecord> ready;
+        bool finished = false;
+        {
+            std::unique_lock<std::mutex> lock(resultsMutex);
+            resultsReady.wait_for(lock, std::chrono::milliseconds(500));
+            for (auto it = results.begin(); it != results.end() && it->first == written; it = results.erase(it)) {
+                ready.push_back(it->second);
+                ++written;
+            }
+            finished = activeWorkers == 0 && results.empty();
+        }
+
+        for (const auto& record : ready) {
+            writeRecord(output, record, options.csv);
+            ++counts[std::min<int>(record.verdict, 2)];
+        }
+        output.flush();
+
+        auto now = std::chrono::steady_clock::now();
+        if (finished || now - lastReport >= std::chrono::seconds(5)) {
+            lastReport = now;
+            double elapsed = std::chrono::duration<double>(now - startTime).count();
+            std::uint64_t done = written - firstDeal;
+            std::fprintf(stderr, "%llu/%llu раздач, %.1f в секунду: выигрышных %llu, нет %llu, неизвестно %llu\n",
+                         static_cast<unsigned long long>(written - options.from),
+                         static_cast<unsigned long long>(options.to - options.from + 1),
+                         elapsed > 0.0 ? done / elapsed : 0.0, static_cast<unsigned long long>(counts[0]),
+                         static_cast<unsigned long long>(counts[1]), static_cast<unsigned long long>(counts[2]));
+        }
+        if (finished) {
+            break;
+        }
+    }
+
+    for (auto& thread : workers) {
+        thread.join();
+    }
+    printThreadStats(threadStats);
+
+    if (g_interrupted) {
+        std::cerr << "Прервано, записано до раздачи " << written - 1 << std::endl;
+        return 130;
+    }
+    output.close();
+    return finish(options);
+}
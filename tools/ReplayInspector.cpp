@@ -0,0 +1,99 @@
+// Просмотр записи партии (Replay.hpp) без окна: сводка, список шагов,
+// позиция перед любым шагом и замер скорости перехода.
+//
+//   ReplayInspector lastgame.replay [--steps] [--at N] [--bench 100000]
+//
+// --steps - все шаги с отметками времени,
+// --at    - позиция перед шагом N (по умолчанию - в конце записи),
+// --bench - столько переходов к случайным шагам, печатается среднее время.
+
+#include "Replay.hpp"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+
+static void printUsage() {
+    std::cerr << "Использование: ReplayInspector FILE [--steps] [--at N] [--bench N]\n";
+}
+
+static std::string stepName(const ReplayStep& step) {
+    const Move& move = step.move;
+    std::string name = step.undo ? "undo " : "";
+    if (move.isDraw()) {
+        return name + "draw " + std::to_string(move.count);
+    }
+    if (move.isRecycle()) {
+        return name + "recycle " + std::to_string(move.count);
+    }
+    name += std::to_string(move.from) + " -> " + std::to_string(move.to) + " x" + std::to_string(move.count);
+    if (move.flipped()) {
+        name += " (flip)";
+    }
+    return name;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        printUsage();
+        return 1;
+    }
+
+    bool listSteps = false;
+    long long at = -1;
+    long long benchCount = 0;
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--steps") {
+            listSteps = true;
+        } else if (arg == "--at" && i + 1 < argc) {
+            at = std::atoll(argv[++i]);
+        } else if (arg == "--bench" && i + 1 < argc) {
+            benchCount = std::atoll(argv[++i]);
+        } else {
+            printUsage();
+            return 1;
+        }
+    }
+
+    ReplayPlayer player;
+    if (!player.open(argv[1])) {
+        std::cerr << "Не удалось прочитать запись " << argv[1] << std::endl;
+        return 1;
+    }
+
+    std::size_t stepCount = player.getStepCount();
+    double seconds = stepCount ? player.getStep(stepCount - 1).millis / 1000.0 : 0.0;
+    std::printf("Раздача %u, взятие по %d\n", player.getDealNumber(), player.getDrawCount());
+    std::printf("Шагов: %zu, снимков: %zu, длительность %.1f с\n", stepCount, player.getCheckpointCount(),
+                seconds);
+
+    if (listSteps) {
+        for (std::size_t i = 0; i < stepCount; ++i) {
+            const ReplayStep& step = player.getStep(i);
+            std::printf("%6zu %9.3f  %s\n", i, step.millis / 1000.0, stepName(step).c_str());
+        }
+    }
+
+    std::size_t target = at < 0 ? stepCount : static_cast<std::size_t>(at);
+    player.seek(target);
+    std::printf("\nПозиция перед шагом %zu:\n%s", player.getPosition(), player.getBoard().toString().c_str());
+
+    if (benchCount > 0 && stepCount > 0) {
+        std::mt19937_64 random(1);
+        std::uniform_int_distribution<std::size_t> distribution(0, stepCount);
+        std::uint64_t checksum = 0;
+        auto startTime = std::chrono::steady_clock::now();
+        for (long long i = 0; i < benchCount; ++i) {
+            player.seek(distribution(random));
+            checksum += player.getBoard().wasteSize;
+        }
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+        std::printf("\nПереходов: %lld, в среднем %.2f мкс (контроль %llu)\n", benchCount,
+                    elapsed * 1e6 / static_cast<double>(benchCount), static_cast<unsigned long long>(checksum));
+    }
+    return 0;
+}
@@ -0,0 +1,151 @@
+// Игра без окна: стратегия играет раздачи подряд на всех ядрах,
+// в конце печатается сводка (доля побед, ходы, скорость).
+//
+//   SelfPlay --policy greedy --from 1 --count 100000 [--draw 3] [--threads 16]
+//            [--max-moves 2000] [--time 0.2] [--seed 1] [--games FILE]
+//
+// --time - бюджет решателя на партию для стратегии solver,
+// --games - CSV по партиям: deal,won,moves,foundation,micros.
+
+#include "SelfPlay.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct Options {
+    std::string policy = "greedy";
+    std::uint64_t from = 1;
+    std::uint64_t count = 10000;
+    int drawCount = 1;
+    int threads = 0;
+    int maxMoves = 2000;
+    double seconds = 0.2;
+    std::uint64_t seed = 1;
+    std::string gamesPath;
+};
+
+static void printUsage() {
+    std::cerr << "Использование: SelfPlay [--policy random|greedy|solver] [--from N] [--count N]\n"
+                 "                 [--draw 1|3] [--threads N] [--max-moves N] [--time SECONDS]\n"
+                 "                 [--seed N] [--games FILE]\n";
+}
+
+static bool parseOptions(int argc, char* argv[], Options& options) {
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        const char* v = argv[i + 1];
+        if (arg == "--policy") {
+            options.policy = v;
+        } else if (arg == "--from") {
+            options.from = std::strtoull(v, nullptr, 10);
+        } else if (arg == "--count") {
+            options.count = std::strtoull(v, nullptr, 10);
+        } else if (arg == "--draw") {
+            options.drawCount = std::atoi(v);
+        } else if (arg == "--threads") {
+            options.threads = std::atoi(v);
+        } else if (arg == "--max-moves") {
+            options.maxMoves = std::atoi(v);
+        } else if (arg == "--time") {
+            options.seconds = std::atof(v);
+        } else if (arg == "--seed") {
+            options.seed = std::strtoull(v, nullptr, 10);
+        } else if (arg == "--games") {
+            options.gamesPath = v;
+        } else {
+            std::cerr << "Неизвестный параметр: " << arg << std::endl;
+            return false;
+        }
+    }
+    if (argc % 2 == 0) {
+        std::cerr << "Не указано значение для " << argv[argc - 1] << std::endl;
+        return false;
+    }
+    return options.count > 0 && options.from + options.count - 1 <= 0xFFFFFFFFULL &&
+           (options.drawCount == 1 || options.drawCount == 3);
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage();
+        return 1;
+    }
+
+    SolverLimits limits;
+    limits.maxSeconds = options.seconds;
+    if (!makePlayPolicy(options.policy, 0, limits)) {
+        std::cerr << "Неизвестная стратегия: " << options.policy << std::endl;
+        return 1;
+    }
+
+    std::ofstream games;
+    if (!options.gamesPath.empty()) {
+        games.open(options.gamesPath, std::ios::trunc);
+        if (!games) {
+            std::cerr << "Не удалось открыть " << options.gamesPath << std::endl;
+            return 1;
+        }
+        games << "deal,won,moves,foundation,micros\n";
+    }
+
+    int threadCount = options.threads > 0 ? options.threads : static_cast<int>(std::thread::hardware_concurrency());
+    threadCount = std::max(threadCount, 1);
+
+    std::atomic<std::uint64_t> next(0);
+    std::mutex mutex;
+    SelfPlayStats total;
+
+    // У каждого потока своя стратегия: стратегии хранят состояние партии
+    auto worker = [&](int index) {
+        auto policy = makePlayPolicy(options.policy, options.seed + static_cast<std::uint64_t>(index), limits);
+        SelfPlayStats stats;
+        std::vector<GameRecord> records;
+        for (std::uint64_t i = next.fetch_add(1); i < options.count; i = next.fetch_add(1)) {
+            auto dealNumber = static_cast<std::uint32_t>(options.from + i);
+            GameRecord record = playGame(dealNumber, *policy, options.drawCount, options.maxMoves);
+            stats.add(record);
+            if (games.is_open()) {
+                records.push_back(record);
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        total.merge(stats);
+        for (const auto& record : records) {
+            games << record.dealNumber << ',' << (record.won ? 1 : 0) << ',' << record.moves << ','
+                  << record.foundationCards << ',' << static_cast<long long>(record.seconds * 1e6) << '\n';
+        }
+    };
+
+    auto startTime = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (int i = 1; i < threadCount; ++i) {
+        workers.emplace_back(worker, i);
+    }
+    worker(0);
+    for (auto& thread : workers) {
+        thread.join();
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+    std::printf("Стратегия %s, взятие по %d, потоков %d\n", options.policy.c_str(), options.drawCount, threadCount);
+    std::printf("Партий:           %llu\n", static_cast<unsigned long long>(total.games));
+    std::printf("Побед:            %llu (%.2f%%)\n", static_cast<unsigned long long>(total.wins),
+                total.winRate() * 100.0);
+    std::printf("Ходов в среднем:  %.1f\n", total.averageMoves());
+    std::printf("Карт в базах:     %.2f в среднем\n",
+                total.games ? static_cast<double>(total.foundationCards) / total.games : 0.0);
+    std::printf("Партий в секунду: %.0f (%.0f на поток)\n", elapsed > 0.0 ? total.games / elapsed : 0.0,
+                total.gamesPerSecond());
+    return 0;
+}